@@ -4181,7 +4181,10 @@ void action_t::trigger_dot( action_state_t* s )
   dot->max_stack      = dot_max_stack;
 
   if ( !dot->state )
+  {
     dot->state = get_state();
+    dot->mark_dirty();
+  }
   dot->state->copy_state( s );
 
   if ( !dot->is_ticking() )
@@ -4682,10 +4685,10 @@ void action_t::reschedule_queue_event()
   }
 }
 rng::rng_t& action_t::rng()
-{ return sim->rng(); }
+{ return player->rng(); }
 
 rng::rng_t& action_t::rng() const
-{ return sim -> rng(); }
+{ return player -> rng(); }
 
 /**
  * Acquire a new target, where the context is the actor that sources the retarget event, and the actor-level candidate
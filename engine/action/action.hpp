@@ -6,6 +6,7 @@
 #pragma once
 
 #include "config.hpp"
+#include "action/action_callback.hpp"
 #include "dbc/data_definitions.hh"
 #include "player/target_specific.hpp"
 #include "sim/cooldown_waste_data.hpp"
@@ -630,6 +631,9 @@ public:
     target_cache_t() : is_valid( false ) {}
   } mutable target_cache;
 
+  /// Callbacks that can trigger from this action, per callback list (see effect_callbacks_t::trigger)
+  std::vector<action_callback_table_t> callback_tables;
+
 private:
   std::vector<std::unique_ptr<option_t>> options;
   action_state_t* state_cache;
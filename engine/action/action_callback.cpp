@@ -16,6 +16,18 @@ action_callback_t::action_callback_t( player_t* l )
     l->callbacks.all_callbacks.push_back( this );
 }
 
+void action_callback_t::activate()
+{
+  active = true;
+  listener->callbacks.invalidate();
+}
+
+void action_callback_t::deactivate()
+{
+  active = false;
+  listener->callbacks.invalidate();
+}
+
 void action_callback_t::trigger( const std::vector<action_callback_t*>& v, action_t* a, action_state_t* state )
 {
   if ( a && !a->player->in_combat )
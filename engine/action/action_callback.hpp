@@ -9,6 +9,7 @@
 
 #include "util/generic.hpp"
 
+#include <cstdint>
 #include <vector>
 
 struct action_t;
@@ -27,10 +28,25 @@ struct action_callback_t : private noncopyable
   virtual void trigger( action_t*, action_state_t* ) = 0;
   virtual void reset() {}
   virtual void initialize() {}
-  virtual void activate() { active = true; }
-  virtual void deactivate() { active = false; }
+  virtual void activate();
+  virtual void deactivate();
+
+  // Return false if the callback can never trigger from the action. Only properties of the action
+  // that do not change during combat may be checked, as the result is cached per action (see
+  // effect_callbacks_t::trigger).
+  virtual bool can_trigger_from( const action_t* ) const
+  { return true; }
 
   static void trigger( const std::vector<action_callback_t*>& v, action_t* a, action_state_t* state );
 
   static void reset( const std::vector<action_callback_t*>& v );
 };
+
+// Indices of the active callbacks of a callback list that can trigger from an action, stored in the
+// action (see effect_callbacks_t::trigger)
+struct action_callback_table_t
+{
+  const std::vector<action_callback_t*>* source;
+  uint64_t generation;
+  std::vector<unsigned> callbacks;
+};
@@ -85,6 +85,25 @@ cooldown_t* dbc_proc_callback_t::get_cooldown( player_t* target )
   return target_specific_cooldown->get_cooldown( target );
 }
 
+bool dbc_proc_callback_t::can_trigger_from( const action_t* a ) const
+{
+  if ( !can_prune_by_action() )
+    return true;
+
+  if ( a->enable_proc_from_suppressed && !can_proc_from_suppressed )
+    return false;
+
+  if ( trigger_type != trigger_fn_type::TRIGGER && can_only_proc_from_class_abilites && !a->allow_class_ability_procs )
+    return false;
+
+  return true;
+}
+
+bool dbc_proc_callback_t::can_prune_by_action() const
+{
+  return prune_by_action;
+}
+
 void dbc_proc_callback_t::trigger( action_t* a, action_state_t* state )
 {
   // all actions with enable_proc_from_suppressed will also have callbacks = false, so check this first thing before
@@ -191,7 +210,8 @@ dbc_proc_callback_t::dbc_proc_callback_t( const item_t& i, const special_effect_
     execute_fn( nullptr ),
     can_only_proc_from_class_abilites( false ),
     can_proc_from_procs( false ),
-    can_proc_from_suppressed( false )
+    can_proc_from_suppressed( false ),
+    prune_by_action( false )
 {
   assert( e.proc_flags() != 0 );
 }
@@ -214,7 +234,8 @@ dbc_proc_callback_t::dbc_proc_callback_t( const item_t* i, const special_effect_
     execute_fn( nullptr ),
     can_only_proc_from_class_abilites( false ),
     can_proc_from_procs( false ),
-    can_proc_from_suppressed( false )
+    can_proc_from_suppressed( false ),
+    prune_by_action( false )
 {
   assert( e.proc_flags() != 0 );
 }
@@ -237,7 +258,8 @@ dbc_proc_callback_t::dbc_proc_callback_t( player_t* p, const special_effect_t& e
     execute_fn( nullptr ),
     can_only_proc_from_class_abilites( false ),
     can_proc_from_procs( false ),
-    can_proc_from_suppressed( false )
+    can_proc_from_suppressed( false ),
+    prune_by_action( false )
 {
   assert( e.proc_flags() != 0 );
 }
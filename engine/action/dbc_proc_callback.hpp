@@ -94,6 +94,10 @@ struct dbc_proc_callback_t : public action_callback_t
   bool can_only_proc_from_class_abilites;
   bool can_proc_from_procs;
   bool can_proc_from_suppressed;
+  /// Opt-in for can_trigger_from() to apply the suppressed and class ability proc rules of
+  /// trigger(), so the callback is not dispatched to actions it can never proc from. Only set for
+  /// callbacks whose trigger() applies those rules unchanged.
+  bool prune_by_action;
 
   dbc_proc_callback_t( const item_t& i, const special_effect_t& e );
 
@@ -107,6 +111,11 @@ struct dbc_proc_callback_t : public action_callback_t
 
   void trigger( action_t* a, action_state_t* state ) override;
 
+  bool can_trigger_from( const action_t* a ) const override;
+
+  // Whether can_trigger_from() may exclude actions, prune_by_action by default
+  virtual bool can_prune_by_action() const;
+
   // Determine target for the callback (action).
   virtual player_t* target( const action_state_t* state, action_t* proc_action = nullptr ) const;
 
@@ -66,7 +66,8 @@ dot_t::dot_t( util::string_view n, player_t* t, player_t* s )
     current_tick(),
     max_stack(),
     name_str( n ),
-    internal_id( s->get_dot_id( n ) )
+    internal_id( s->get_dot_id( n ) ),
+    dirty( true )
 {
 }
 
@@ -178,6 +179,21 @@ void dot_t::reset()
     action_state_t::release( state );
 }
 
+void dot_t::mark_dirty()
+{
+  if ( !dirty )
+  {
+    dirty = true;
+    target->dirty_dot_list.push_back( this );
+  }
+}
+
+bool dot_t::is_reset() const
+{
+  return !ticking && !tick_event && !end_event && !state && tick_time == 0_ms && current_tick == 0 && stack == 0 &&
+         extra_time == 0_ms && current_duration == timespan_t::min();
+}
+
 /* Trigger a dot with given duration.
  * Main function to start/refresh a dot
  */
@@ -185,6 +201,8 @@ void dot_t::trigger( timespan_t duration )
 {
   assert( duration > 0_ms && "Dot Trigger with duration <= 0 seconds." );
 
+  mark_dirty();
+
   current_tick = 0;
   extra_time   = 0_ms;
 
@@ -264,6 +282,7 @@ void dot_t::copy( player_t* destination, dot_copy_e copy_type, action_t* copy_ac
   {
     target_state     = copy_action->get_state( state );
     other_dot->state = target_state;
+    other_dot->mark_dirty();
   }
   else
   {
@@ -849,6 +868,8 @@ void dot_t::schedule_tick()
 
 void dot_t::start( timespan_t duration )
 {
+  mark_dirty();
+
   current_duration = duration;
 
   ticking = true;
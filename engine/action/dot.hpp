@@ -45,6 +45,9 @@ public:
   int max_stack;
   std::string name_str;
   int internal_id;
+  // Set when the dot state changed since the last reset. Dirty dots are recorded in the
+  // dirty_dot_list of the target, and reset at the end of the iteration (see player_t::reset).
+  bool dirty;
 
   dot_t(util::string_view n, player_t* target, player_t* source);
 
@@ -56,6 +59,9 @@ public:
   }
   void   refresh_duration(uint32_t state_flags = -1);
   void   reset();
+  void   mark_dirty();
+  // Return true if the dot is in the state reset() leaves it in
+  bool   is_reset() const;
   void   cancel();
   void   trigger(timespan_t duration);
   void   decrement(int stacks);
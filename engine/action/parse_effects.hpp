@@ -67,6 +67,28 @@ struct action_effect_t
   { eff = e; return *this; }
 };
 
+// List of action effects that caches its combined value (see parse_action_effects_t::get_effects_value). The cache
+// is only used if no effect has a condition function or uses the current buff value, as changes to those are not
+// tracked.
+struct action_effects_t : public std::vector<action_effect_t>
+{
+  struct cache_t
+  {
+    size_t size = 0;  // Size of the list when cacheability was determined
+    bool cacheable = false;
+    bool mastery = false;  // Value depends on mastery
+    bool valid = false;
+    bool flat = false;
+    bool benefit = false;
+    double value = 0.0;
+    uint64_t generation = 0;  // sim_t::buff_stack_generation of the cached value
+    double mastery_value = 0.0;
+    timespan_t time = timespan_t::min();
+  };
+
+  mutable cache_t cache;
+};
+
 // TODO: add value type to debuffs if it becomes necessary in the future
 template <typename TD>
 struct target_effect_t
@@ -288,15 +310,15 @@ private:
 
 public:
   // auto parsed dynamic effects
-  std::vector<action_effect_t> ta_multiplier_effects;
-  std::vector<action_effect_t> da_multiplier_effects;
-  std::vector<action_effect_t> execute_time_effects;
-  std::vector<action_effect_t> dot_duration_effects;
-  std::vector<action_effect_t> tick_time_effects;
-  std::vector<action_effect_t> recharge_multiplier_effects;
-  std::vector<action_effect_t> cost_effects;
-  std::vector<action_effect_t> flat_cost_effects;
-  std::vector<action_effect_t> crit_chance_effects;
+  action_effects_t ta_multiplier_effects;
+  action_effects_t da_multiplier_effects;
+  action_effects_t execute_time_effects;
+  action_effects_t dot_duration_effects;
+  action_effects_t tick_time_effects;
+  action_effects_t recharge_multiplier_effects;
+  action_effects_t cost_effects;
+  action_effects_t flat_cost_effects;
+  action_effects_t crit_chance_effects;
   std::vector<target_effect_t<TD>> target_multiplier_effects;
   std::vector<target_effect_t<TD>> target_crit_damage_effects;
   std::vector<target_effect_t<TD>> target_crit_chance_effects;
@@ -661,6 +683,46 @@ public:
     return return_value;
   }
 
+  // Cached version of the above. The cached value is valid while no buff stacks (sim_t::buff_stack_generation) or
+  // mastery change. With benefit tracking, the value is also only reused within the same sim time, as stack() records
+  // the benefit once per buff and time.
+  double get_effects_value( const action_effects_t& effects, bool flat = false, bool benefit = true ) const
+  {
+    const std::vector<action_effect_t>& list = effects;
+    auto& cache = effects.cache;
+
+    if ( cache.size != list.size() )
+    {
+      cache.size      = list.size();
+      cache.cacheable = !range::any_of( list, []( const action_effect_t& e ) { return e.func || e.type == USE_CURRENT; } );
+      cache.mastery   = range::any_of( list, []( const action_effect_t& e ) { return e.mastery; } );
+      cache.valid     = false;
+    }
+
+    if ( !cache.cacheable )
+      return get_effects_value( list, flat, benefit );
+
+    double mastery_value = cache.mastery ? BASE::player->cache.mastery() : 0.0;
+
+    if ( cache.valid && cache.flat == flat && cache.benefit == benefit &&
+         cache.generation == BASE::sim->buff_stack_generation && cache.mastery_value == mastery_value &&
+         ( !benefit || cache.time == BASE::sim->current_time() ) )
+    {
+      assert( cache.value == get_effects_value( list, flat, false ) && "Stale cached action effects value" );
+      return cache.value;
+    }
+
+    cache.value         = get_effects_value( list, flat, benefit );
+    cache.valid         = true;
+    cache.flat          = flat;
+    cache.benefit       = benefit;
+    cache.generation    = BASE::sim->buff_stack_generation;
+    cache.mastery_value = mastery_value;
+    cache.time          = BASE::sim->current_time();
+
+    return cache.value;
+  }
+
   // Syntax: parse_target_effects( func, debuff[, spells|ignore_mask][,...] )
   //   (int F(TD*))            func: Function taking the target_data as argument and returning an integer mutiplier
   //   (const spell_data_t*) debuff: Spell data of the debuff
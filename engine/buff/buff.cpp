@@ -669,7 +669,9 @@ buff_t::buff_t( sim_t* sim, player_t* target, player_t* source, util::string_vie
     start_intervals(),
     trigger_intervals(),
     duration_lengths(),
-    change_regen_rate( false )
+    change_regen_rate( false ),
+    dirty( true ),
+    reset_index( 0 )
 {
   if ( source )  // Player Buffs
   {
@@ -677,12 +679,16 @@ buff_t::buff_t( sim_t* sim, player_t* target, player_t* source, util::string_vie
     range::erase_remove( player->fallback_buff_names, [ name, source ]( const auto& f ) {
       return f.first == name && f.second == source;
     } );
+    reset_index = player->buff_list.size();
     player->buff_list.push_back( this );
+    player->dirty_buff_list.push_back( this );
+    player->buff_name_index.add( this );
     cooldown = source->get_cooldown( "buff_" + name_str );
   }
   else  // Sim Buffs
   {
     sim->buff_list.push_back( this );
+    sim->buff_name_index.add( this );
     cooldown = sim->get_cooldown( "buff_" + name_str );
   }
 
@@ -840,6 +846,8 @@ buff_t* buff_t::set_dynamic_time_duration_multiplier( double new_multiplier )
   if ( new_multiplier == dynamic_time_duration_multiplier )
     return this;
 
+  mark_dirty();
+
   auto old_multiplier = dynamic_time_duration_multiplier;
   dynamic_time_duration_multiplier = new_multiplier;
 
@@ -1954,6 +1962,8 @@ bool buff_t::trigger( int stacks, timespan_t duration )
 
 bool buff_t::trigger( int stacks, double value, double chance, timespan_t duration )
 {
+  mark_dirty();
+
   if ( _max_stack == 0 || chance == 0 )
     return false;
 
@@ -2030,6 +2040,8 @@ bool buff_t::trigger( int stacks, double value, double chance, timespan_t durati
 
 void buff_t::execute( int stacks, double value, timespan_t duration )
 {
+  mark_dirty();
+
   if ( value == DEFAULT_VALUE() && default_value != DEFAULT_VALUE() )
     value = default_value;
 
@@ -2115,6 +2127,7 @@ void buff_t::decrement( int stacks, double value )
       stack_uptime[ current_stack ].update( false, sim->current_time() );
 
     current_stack -= stacks;
+    sim->buff_stack_generation++;
 
     if ( value != DEFAULT_VALUE() )
       current_value = value;
@@ -2211,6 +2224,8 @@ void buff_t::extend_duration_or_trigger( timespan_t duration, player_t* p )
 
 void buff_t::start( int stacks, double value, timespan_t duration )
 {
+  mark_dirty();
+
   if ( _max_stack == 0 )
     return;
 
@@ -2408,6 +2423,8 @@ void buff_t::refresh( int stacks, double value, timespan_t duration )
 
 void buff_t::bump( int stacks, double value )
 {
+  mark_dirty();
+
   if ( _max_stack == 0 )
     return;
 
@@ -2425,6 +2442,7 @@ void buff_t::bump( int stacks, double value )
   current_value = value;
 
   int old_stack = current_stack;
+  sim->buff_stack_generation++;
 
   if ( max_stack() < 0 )
   {
@@ -2547,6 +2565,8 @@ void buff_t::bump( int stacks, double value )
 
 void buff_t::override_buff( int stacks, double value )
 {
+  mark_dirty();
+
   if ( _max_stack == 0 )
     return;
 
@@ -2633,6 +2653,7 @@ void buff_t::expire( timespan_t delay )
   int old_stack = current_stack;
 
   current_stack = 0;
+  sim->buff_stack_generation++;
 
   if ( last_start >= timespan_t::zero() )
   {
@@ -2748,6 +2769,22 @@ void buff_t::reset()
   dynamic_time_duration_multiplier = 1.0;
 }
 
+void buff_t::mark_dirty()
+{
+  if ( !dirty )
+  {
+    dirty = true;
+    player->dirty_buff_list.push_back( this );
+  }
+}
+
+bool buff_t::is_reset() const
+{
+  return current_stack == 0 && expiration.empty() && !delay && !expiration_delay && !tick_event &&
+         last_start == timespan_t::min() && last_trigger == timespan_t::min() && last_expire == timespan_t::min() &&
+         last_stack_change == timespan_t::min() && dynamic_time_duration_multiplier == 1.0;
+}
+
 void buff_t::merge( const buff_t& other )
 {
   start_intervals.merge( other.start_intervals );
@@ -2763,7 +2800,7 @@ void buff_t::merge( const buff_t& other )
   avg_overflow_count.merge( other.avg_overflow_count );
   avg_overflow_total.merge( other.avg_overflow_total );
   if ( sim->buff_uptime_timeline )
-    uptime_array.merge( other.uptime_array );
+    uptime_timeline.merge( other.uptime_timeline );
 
 #ifndef NDEBUG
   if ( stack_uptime.size() != other.stack_uptime.size() )
@@ -2780,6 +2817,12 @@ void buff_t::merge( const buff_t& other )
 
 void buff_t::analyze()
 {
+  if ( sim->buff_uptime_timeline && !uptime_timeline.empty() )
+  {
+    uptime_timeline.materialize( uptime_array );
+    uptime_timeline.clear();
+  }
+
   // Aura with no uptime_array data will return uptime_array.mean() == 0 and are not reported in neither the JSON nor
   // HTML outputs, so no need to adjust them.
   if ( sim->buff_uptime_timeline && uptime_array.mean() != 0 )
@@ -2827,6 +2870,21 @@ buff_t* buff_t::find( util::span<buff_t* const> buffs, util::string_view name_st
   return nullptr;
 }
 
+// Same as find( span, name, source ) on the list the index was built from
+static buff_t* find_indexed( const name_index_t<buff_t>& index, util::string_view name_str, player_t* source )
+{
+  if ( !source )
+    return index.find( name_str );
+
+  for ( buff_t* buff : index.find_all( name_str ) )
+  {
+    if ( source == buff->source )
+      return buff;
+  }
+
+  return nullptr;
+}
+
 namespace
 {
 struct potion_spell_filter
@@ -2883,6 +2941,14 @@ buff_t* buff_t::find_expressable( util::span<buff_t* const> buffs, util::string_
     return find( buffs, name, source );
 }
 
+buff_t* buff_t::find_expressable( player_t* p, util::string_view name, player_t* source )
+{
+  if ( util::str_compare_ci( "potion", name ) )
+    return find_potion_buff( p->buff_list, source );
+  else
+    return find_indexed( p->buff_name_index, name, source );
+}
+
 buff_t* buff_t::make_fallback( player_t* player, std::string_view name, player_t* source )
 {
   for ( const auto& fb : player->fallback_buff_names )
@@ -2943,7 +3009,7 @@ void buff_t::invalidate_cache()
 
 buff_t* buff_t::find( sim_t* s, util::string_view name )
 {
-  return find( s->buff_list, name );
+  return s->buff_name_index.find( name );
 }
 
 buff_t* buff_t::find( player_t* p, util::string_view name, player_t* source )
@@ -2952,7 +3018,7 @@ buff_t* buff_t::find( player_t* p, util::string_view name, player_t* source )
     if ( fb.first == name && fb.second == source )
       return p->sim->auras.fallback;
 
-  return find( p->buff_list, name, source );
+  return find_indexed( p->buff_name_index, name, source );
 }
 
 const char* buff_t::name_reporting() const
@@ -2973,7 +3039,7 @@ util::string_view buff_t::source_name() const
 
 rng::rng_t& buff_t::rng()
 {
-  return sim->rng();
+  return player ? player->rng() : sim->rng();
 }
 
 /**
@@ -3027,36 +3093,18 @@ void buff_t::update_stack_uptime_array( timespan_t current_time, int old_stacks
   if ( !sim->buff_uptime_timeline )
     return;
 
-  // No data collection done on first iteration of multi-iteration sim, as per sim_t::combat_end()
-  if ( sim->iterations > 1 && sim->current_iteration == 0 )
+  // No data collection done on warm up iterations, as per sim_t::combat_end()
+  if ( !sim->collect_iteration() )
     return;
 
-  if ( constant || overridden || old_stacks <= 0 )
+  // Quiet buffs are not reported
+  if ( constant || overridden || quiet || old_stacks <= 0 )
     return;
 
   timespan_t last_time = sim->buff_stack_uptime_timeline ? last_stack_change : last_start;
   int mul = sim->buff_stack_uptime_timeline ? old_stacks : 1;
 
-  timespan_t start_time    = timespan_t::from_seconds( last_time.total_millis() / 1000 );
-  timespan_t end_time      = timespan_t::from_seconds( current_time.total_millis() / 1000 );
-  timespan_t begin_partial = 1_s - ( last_time % 1_s );
-  timespan_t end_partial   = ( current_time % 1_s );
-
-  if ( last_time % 1_s == timespan_t::zero() )
-    begin_partial = 1_s;
-
-  if ( start_time == end_time )
-  {
-    uptime_array.add( start_time, ( current_time.total_seconds() - last_time.total_seconds() ) * mul );
-    return;
-  }
-
-  uptime_array.add( start_time, begin_partial.total_seconds() * mul );
-
-  for ( timespan_t i = start_time + 1000_ms; i < end_time; i = i + 1000_ms )
-    uptime_array.add( i, mul );
-
-  uptime_array.add( end_time, end_partial.total_seconds() * mul );
+  uptime_timeline.add( last_time, current_time, mul );
 }
 
 void sc_format_to( const buff_t& buff, fmt::format_context::iterator out )
@@ -3293,6 +3341,7 @@ void stat_buff_t::decrement( int stacks, double /* value */ )
       buff_stat.current_value -= delta;
     }
     current_stack -= stacks;
+    sim->buff_stack_generation++;
 
     invalidate_cache();
 
@@ -3398,6 +3447,7 @@ void cost_reduction_buff_t::decrement( int stacks, double /* value */ )
     double delta = amount * stacks;
     player->cost_reduction_loss( school, delta );
     current_stack -= stacks;
+    sim->buff_stack_generation++;
     current_value -= delta;
   }
 }
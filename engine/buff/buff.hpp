@@ -69,6 +69,9 @@ public:
   event_t* delay;
   event_t* expiration_delay;
   cooldown_t* cooldown;
+  // Uptime (or stack uptime) per second, collected as run deltas and materialized into uptime_array
+  // when analyzed. Not collected for constant, overridden and quiet buffs, which are not reported.
+  delta_timeline_t uptime_timeline;
   sc_timeline_t uptime_array;
   real_ppm_t* rppm;
 
@@ -273,6 +276,10 @@ public:
   virtual void expire_override( int /* expiration_stacks */, timespan_t /* remaining_duration */ ) {}
   virtual void predict();
   virtual void reset();
+  // Record a state change, so the buff is reset at the end of the iteration
+  void mark_dirty();
+  // Return true if the buff is in the state buff_t::reset() leaves it in
+  bool is_reset() const;
   virtual void aura_gain();
   virtual void aura_loss();
   virtual void merge( const buff_t& other_buff );
@@ -307,6 +314,7 @@ public:
   static buff_t* find( sim_t*, util::string_view name );
   static buff_t* find( player_t*, util::string_view name, player_t* source = nullptr );
   static buff_t* find_expressable( util::span<buff_t* const>, util::string_view name, player_t* source = nullptr );
+  static buff_t* find_expressable( player_t*, util::string_view name, player_t* source = nullptr );
   static buff_t* make_fallback( player_t* player, std::string_view name, player_t* source = nullptr );
 
   // If first argument is true, create a buff per normal
@@ -348,6 +356,13 @@ public:
   rng::rng_t& rng();
 
   bool change_regen_rate;
+  // Set when the buff was triggered or started since the last reset. Dirty buffs of an actor are
+  // recorded in its dirty_buff_list, and reset at the end of the iteration (see player_t::reset).
+  // Buffs that change state of their own outside of trigger(), execute(), start() and bump() must
+  // call mark_dirty() so their reset() runs. Sim buffs stay dirty.
+  bool dirty;
+  // Position of the buff in the buff_list of its actor, dirty buffs are reset in this order
+  size_t reset_index;
 
   buff_t* set_chance( double chance );
   buff_t* set_duration( timespan_t duration );
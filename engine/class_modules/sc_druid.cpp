@@ -167,8 +167,8 @@ struct snapshot_counter_t
 
   void count_execute()
   {
-    // Skip iteration 0 for non-debug, non-log sims
-    if ( sim->current_iteration == 0 && sim->iterations > sim->threads && !sim->debug && !sim->log )
+    // No data collection done on warm up iterations, as per sim_t::combat_end()
+    if ( !sim->collect_iteration() )
       return;
 
     execute.add( check_all() );
@@ -176,8 +176,8 @@ struct snapshot_counter_t
 
   void count_tick()
   {
-    // Skip iteration 0 for non-debug, non-log sims
-    if ( sim->current_iteration == 0 && sim->iterations > sim->threads && !sim->debug && !sim->log )
+    // No data collection done on warm up iterations, as per sim_t::combat_end()
+    if ( !sim->collect_iteration() )
       return;
 
     tick.add( is_snapped );
@@ -2077,7 +2077,7 @@ protected:
   bool attack_critical;
 
 public:
-  std::vector<action_effect_t> persistent_multiplier_effects;
+  action_effects_t persistent_multiplier_effects;
 
   struct
   {
@@ -5727,6 +5727,7 @@ struct lava_burst_t : public shaman_spell_t
     {
       d                      = timespan_t::zero();
       cooldown->last_charged = sim->current_time();
+      cooldown->mark_dirty();
     }
 
     shaman_spell_t::update_ready( d );
@@ -8718,6 +8719,7 @@ inline bool ascendance_buff_t::trigger( int stacks, double value, double chance,
   if ( lava_burst )
   {
     lava_burst->cooldown->last_charged = timespan_t::zero();
+    lava_burst->cooldown->mark_dirty();
   }
 
   return buff_t::trigger( stacks, value, chance, duration );
@@ -8734,6 +8736,7 @@ inline void ascendance_buff_t::expire_override( int expiration_stacks, timespan_
   if ( lava_burst )
   {
     lava_burst->cooldown->last_charged = sim->current_time();
+    lava_burst->cooldown->mark_dirty();
   }
   buff_t::expire_override( expiration_stacks, remaining_duration );
 }
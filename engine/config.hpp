@@ -157,6 +157,11 @@ constexpr double m_pi = 3.14159265358979323846;
 
 #define SC_USE_STAT_CACHE
 
+// Count stat cache hits, misses and invalidations per cache, and report them in the "Stat Cache"
+// sections of the HTML and JSON reports. Every cache access updates a counter, so it is off by
+// default; define SC_STAT_CACHE_COUNTERS when tuning the stat cache.
+// #define SC_STAT_CACHE_COUNTERS
+
 #ifndef NDEBUG
 #define ACTOR_EVENT_BOOKKEEPING
 #endif
@@ -8,6 +8,7 @@
 #include "config.hpp"
 
 #include <algorithm>
+#include <cstdint>
 #include <vector>
 #include <string>
 
@@ -59,6 +60,89 @@ const T& find_indexed( unsigned key, util::span<const T, N> data, util::span<con
   return T::nil();
 }
 
+// Hash index from id to the first entry with that id in dbc data, for data that is looked up by id
+// often. Open addressing with linear probing, kept at most 3/4 full so most lookups take a single
+// probe.
+template <typename T>
+class id_index_t
+{
+  struct slot_t
+  {
+    unsigned key;
+    const T* value;
+  };
+
+  std::vector<slot_t> slots;
+  unsigned shift;
+
+  size_t slot( unsigned key ) const
+  { return static_cast<uint32_t>( key * 2654435769U ) >> shift; }
+
+public:
+  explicit id_index_t( size_t n_entries ) : shift( 31 )
+  {
+    size_t n_slots = 2;
+    while ( n_slots < n_entries + n_entries / 3 + 1 )
+    {
+      n_slots <<= 1;
+      --shift;
+    }
+    slots.resize( n_slots, slot_t{ 0, nullptr } );
+  }
+
+  // Add an entry, unless an entry with the same key was added before
+  void insert( unsigned key, const T* value )
+  {
+    for ( size_t i = slot( key );; i = ( i + 1 ) & ( slots.size() - 1 ) )
+    {
+      if ( !slots[ i ].value )
+      {
+        slots[ i ] = { key, value };
+        return;
+      }
+
+      if ( slots[ i ].key == key )
+        return;
+    }
+  }
+
+  const T* find( unsigned key ) const
+  {
+    for ( size_t i = slot( key );; i = ( i + 1 ) & ( slots.size() - 1 ) )
+    {
+      if ( !slots[ i ].value )
+        return nullptr;
+
+      if ( slots[ i ].key == key )
+        return slots[ i ].value;
+    }
+  }
+};
+
+template <typename T, typename Proj>
+id_index_t<T> make_id_index( util::span<const T> data, Proj proj )
+{
+  id_index_t<T> index( data.size() );
+  for ( const auto& entry : data )
+    index.insert( std::invoke( proj, entry ), &entry );
+  return index;
+}
+
+// Index of the live or PTR data, built by build( ptr ) on first use. Initialization is thread safe.
+// Each call site must pass its own build function (lambda), as the index is stored per Build type.
+template <typename Build>
+const auto& lazy_index( bool ptr, Build build )
+{
+  if ( ptr )
+  {
+    static const auto ptr_index = build( true );
+    return ptr_index;
+  }
+
+  static const auto index = build( false );
+  return index;
+}
+
 // "Index" to provide access to a filtered list of dbc data.
 template <typename T, typename Filter>
 class filtered_dbc_index_t
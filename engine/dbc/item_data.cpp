@@ -11,16 +11,21 @@
 
 const dbc_item_data_t& dbc_item_data_t::find( unsigned id, bool ptr )
 {
-  const auto _data = data( ptr );
-  auto chunk = range::find_if( _data, [id]( util::span<const dbc_item_data_t> chunk ) {
-      return id >= chunk.front().id && id <= chunk.back().id;
-    } );
-  if ( chunk == _data.end() )
-    return nil();
-
-  auto it = range::lower_bound( *chunk, id, {}, &dbc_item_data_t::id );
-  if ( it != chunk->end() && it->id == id )
-    return *it;
+  const auto& index = dbc::lazy_index( ptr, []( bool ptr ) {
+    size_t n_items = 0;
+    for ( auto chunk : data( ptr ) )
+      n_items += chunk.size();
+
+    dbc::id_index_t<dbc_item_data_t> index( n_items );
+    for ( auto chunk : data( ptr ) )
+    {
+      for ( const auto& item : chunk )
+        index.insert( item.id, &item );
+    }
+    return index;
+  } );
+  if ( const dbc_item_data_t* item = index.find( id ) )
+    return *item;
 
   return nil();
 }
@@ -362,8 +362,12 @@ unsigned spelleffect_data_t::affected_schools() const
 
 const spelleffect_data_t* spelleffect_data_t::find( unsigned id, bool ptr )
 {
-  const auto index = SC_DBC_GET_DATA( __spelleffect_id_index, __ptr_spelleffect_id_index, ptr );
-  return &dbc::find_indexed( id, data( ptr ), index, &spelleffect_data_t::id );
+  const auto& index = dbc::lazy_index( ptr, []( bool ptr ) {
+    return dbc::make_id_index( data( ptr ), &spelleffect_data_t::id );
+  } );
+  if ( const spelleffect_data_t* effect = index.find( id ) )
+    return effect;
+  return &spelleffect_data_t::nil();
 }
 
 util::span<const spelleffect_data_t> spelleffect_data_t::data( bool ptr )
@@ -500,10 +504,11 @@ bool spell_data_t::affected_by( const spelleffect_data_t& effect ) const
 
 const spell_data_t* spell_data_t::find( unsigned spell_id, bool ptr )
 {
-  const auto __data = data( ptr );
-  auto it = range::lower_bound( __data, spell_id, {}, &spell_data_t::id );
-  if ( it != __data.end() && it->id() == spell_id )
-    return &*it;
+  const auto& index = dbc::lazy_index( ptr, []( bool ptr ) {
+    return dbc::make_id_index( data( ptr ), &spell_data_t::id );
+  } );
+  if ( const spell_data_t* spell = index.find( spell_id ) )
+    return spell;
   return spell_data_t::nil();
 }
 
@@ -516,12 +521,33 @@ const spell_data_t* spell_data_t::find( unsigned spell_id, util::string_view con
   return p;
 }
 
+namespace
+{
+// Spells sorted by name, spells with the same name in spell id order
+std::vector<const spell_data_t*> build_name_index( util::span<const spell_data_t> data )
+{
+  std::vector<const spell_data_t*> index;
+  index.reserve( data.size() );
+  for ( const auto& spell : data )
+    index.push_back( &spell );
+
+  std::stable_sort( index.begin(), index.end(), []( const spell_data_t* l, const spell_data_t* r ) {
+    return util::string_view( l->name_cstr() ) < util::string_view( r->name_cstr() );
+  } );
+
+  return index;
+}
+}  // namespace
+
 const spell_data_t* spell_data_t::find( util::string_view name, bool ptr )
 {
-  const auto __data = data( ptr );
-  auto it = range::find( __data, name, &spell_data_t::name_cstr );
-  if ( it != __data.end() )
-    return &*it;
+  const auto& index = dbc::lazy_index( ptr, []( bool ptr ) {
+    return build_name_index( data( ptr ) );
+  } );
+  auto it = range::lower_bound( index, name, {},
+                                []( const spell_data_t* spell ) { return util::string_view( spell->name_cstr() ); } );
+  if ( it != index.end() && name == ( *it )->name_cstr() )
+    return *it;
   return nullptr;
 }
 
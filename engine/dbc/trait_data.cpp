@@ -39,12 +39,13 @@ util::span<const trait_data_t> trait_data_t::data( unsigned class_id, talent_tre
 
 const trait_data_t* trait_data_t::find( unsigned trait_node_entry_id, bool ptr )
 {
-  auto _data = data( ptr );
-  auto _it = range::find( _data, trait_node_entry_id, &trait_data_t::id_trait_node_entry );
+  const auto& index = dbc::lazy_index( ptr, []( bool ptr ) {
+    return dbc::make_id_index( data( ptr ), &trait_data_t::id_trait_node_entry );
+  } );
 
-  if ( _it != _data.end() )
+  if ( const trait_data_t* trait = index.find( trait_node_entry_id ) )
   {
-    return _it;
+    return trait;
   }
 
   return &( nil() );
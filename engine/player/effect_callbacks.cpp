@@ -4,6 +4,7 @@
 // ==========================================================================
 #include "effect_callbacks.hpp"
 
+#include "action/action.hpp"
 #include "action/action_callback.hpp"
 #include "action/dbc_proc_callback.hpp"
 #include "item/special_effect.hpp"
@@ -24,6 +25,8 @@ void add_callback( std::vector<action_callback_t*>& callbacks, action_callback_t
 
 void effect_callbacks_t::add_callback( proc_types type, proc_types2 type2, action_callback_t* cb )
 {
+  invalidate();
+
   ::add_callback( procs[ type ][ type2 ], cb );
 
   if ( cb->allow_pet_procs )
@@ -227,6 +230,67 @@ void effect_callbacks_t::register_callback( uint64_t proc_flags, uint64_t proc_f
   }
 }
 
+/**
+ * Trigger callbacks through the callback table of the action for the list. The table holds the active
+ * callbacks of the list that can trigger from the action, and is rebuilt when callbacks are added,
+ * activated or deactivated. If that happens during the triggering, the rest of the list is checked
+ * as is.
+ */
+void effect_callbacks_t::trigger( const proc_list_t& callbacks, action_t* a, action_state_t* state )
+{
+  if ( !a )
+  {
+    action_callback_t::trigger( callbacks, a, state );
+    return;
+  }
+
+  if ( !a->player->in_combat || callbacks.empty() )
+    return;
+
+  auto& tables = a->callback_tables;
+  auto table_index = static_cast<size_t>(
+      range::find_if( tables, [ &callbacks ]( const action_callback_table_t& t ) { return t.source == &callbacks; } ) -
+      tables.begin() );
+  if ( table_index == tables.size() )
+  {
+    tables.push_back( { &callbacks, 0, {} } );
+  }
+
+  auto list_size = as<unsigned>( callbacks.size() );
+  if ( tables[ table_index ].generation != generation )
+  {
+    auto& table = tables[ table_index ];
+    table.callbacks.clear();
+    for ( unsigned i = 0; i < list_size; i++ )
+    {
+      if ( callbacks[ i ]->active && callbacks[ i ]->can_trigger_from( a ) )
+        table.callbacks.push_back( i );
+    }
+    table.generation = generation;
+  }
+
+  // Callbacks may trigger (nested) callbacks of the action, so the table is accessed by index
+  auto current = generation;
+  for ( size_t i = 0, size = tables[ table_index ].callbacks.size(); i < size; i++ )
+  {
+    unsigned index = tables[ table_index ].callbacks[ i ];
+    action_callback_t* cb = callbacks[ index ];
+    if ( cb->active )
+      cb->trigger( a, state );
+
+    if ( generation != current )
+    {
+      for ( index++; index < list_size; index++ )
+      {
+        cb = callbacks[ index ];
+        if ( cb->active && cb->can_trigger_from( a ) )
+          cb->trigger( a, state );
+      }
+      return;
+    }
+  }
+}
+
 void effect_callbacks_t::reset()
 {
   action_callback_t::reset( all_callbacks );
@@ -37,7 +37,11 @@ struct effect_callbacks_t
   proc_array_t procs;
   proc_array_t pet_procs;  // callbacks that can proc from pets
 
-  effect_callbacks_t( sim_t* sim ) : sim( sim ) {}
+  // Incremented when callbacks are added, activated or deactivated, to rebuild the per-action
+  // callback tables
+  uint64_t generation;
+
+  effect_callbacks_t( sim_t* sim ) : sim( sim ), generation( 1 ) {}
 
   bool has_callback( const std::function<bool( const action_callback_t* )> cmp ) const;
 
@@ -45,6 +49,12 @@ struct effect_callbacks_t
 
   void reset();
 
+  void invalidate()
+  { ++generation; }
+
+  /// Trigger the callbacks of a list of this object (procs or pet_procs) that can trigger from the action
+  void trigger( const proc_list_t& callbacks, action_t* a, action_state_t* state );
+
   void register_callback( uint64_t proc_flags, uint64_t proc_flags2, action_callback_t* cb );
   /// Register a driver-specific custom trigger callback
   void register_callback_trigger_function( unsigned driver_id, dbc_proc_callback_t::trigger_fn_type t,
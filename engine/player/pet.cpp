@@ -394,7 +394,7 @@ void pet_t::trigger_callbacks( proc_types type, proc_types2 type2, action_t* act
 
   // currently only works for pets and guardians.
   if ( this->type == PLAYER_GUARDIAN || this->type == PLAYER_PET )
-    action_callback_t::trigger( owner->callbacks.pet_procs[ type ][ type2 ], action, state );
+    owner->callbacks.trigger( owner->callbacks.pet_procs[ type ][ type2 ], action, state );
 }
 
 void pet_t::init_finished()
@@ -516,8 +516,9 @@ T* pet_spawner_t<T, O>::pet( size_t index ) const
 template <typename T, typename O>
 void pet_spawner_t<T, O>::merge( base_actor_spawner_t* other )
 {
-  // This method should not be invoked from non-main threads
-  if ( m_owner -> sim -> parent )
+  // Thread children merge dynamic pets of the threads below them in the merge tree. Other sims
+  // with a parent (e.g., profilesets) do not merge dynamic pets.
+  if ( m_owner -> sim -> parent && m_owner -> sim -> thread_index == 0 )
   {
     return;
   }
@@ -1236,6 +1236,7 @@ player_t::player_t( sim_t* s, player_e t, util::string_view n, race_e r )
 {
   actor_index = sim->actor_list.size();
   sim->actor_list.push_back( this );
+  sim->actor_name_index.add( this );
 
   if ( ! is_enemy() && ! is_pet() )
   {
@@ -5329,111 +5330,98 @@ double player_t::composite_mastery_value() const
 
 #if defined( SC_USE_STAT_CACHE )
 
+namespace
+{
+/* Declared dependencies between stat caches: invalidating 'from' invalidates 'to'. Edges with a
+ * conversion ratio only apply while that ratio is positive in the player's current stats.
+ * Aggregate caches ( eg. CACHE_HASTE ) only exist to invalidate their member caches.
+ */
+struct stat_cache_dependency_t
+{
+  cache_e from, to;
+  double player_t::base_initial_current_t::*ratio;
+};
+
+const stat_cache_dependency_t stat_cache_dependencies[] = {
+  { CACHE_STRENGTH,           CACHE_ATTACK_POWER,           &player_t::base_initial_current_t::attack_power_per_strength },
+  { CACHE_STRENGTH,           CACHE_PARRY,                  &player_t::base_initial_current_t::parry_per_strength },
+  { CACHE_AGILITY,            CACHE_ATTACK_POWER,           &player_t::base_initial_current_t::attack_power_per_agility },
+  { CACHE_AGILITY,            CACHE_DODGE,                  &player_t::base_initial_current_t::dodge_per_agility },
+  { CACHE_AGILITY,            CACHE_ATTACK_CRIT_CHANCE,     &player_t::base_initial_current_t::attack_crit_per_agility },
+  { CACHE_INTELLECT,          CACHE_SPELL_POWER,            &player_t::base_initial_current_t::spell_power_per_intellect },
+  { CACHE_INTELLECT,          CACHE_SPELL_CRIT_CHANCE,      &player_t::base_initial_current_t::spell_crit_per_intellect },
+  { CACHE_SPELL_POWER,        CACHE_ATTACK_POWER,           &player_t::base_initial_current_t::attack_power_per_spell_power },
+  { CACHE_ATTACK_POWER,       CACHE_SPELL_POWER,            &player_t::base_initial_current_t::spell_power_per_attack_power },
+  { CACHE_ATTACK_HASTE,       CACHE_ATTACK_SPEED,           nullptr },
+  { CACHE_ATTACK_HASTE,       CACHE_RPPM_HASTE,             nullptr },
+  { CACHE_SPELL_HASTE,        CACHE_SPELL_SPEED,            nullptr },
+  { CACHE_SPELL_HASTE,        CACHE_RPPM_HASTE,             nullptr },
+  { CACHE_BONUS_ARMOR,        CACHE_ARMOR,                  nullptr },
+  { CACHE_ATTACK_CRIT_CHANCE, CACHE_RPPM_CRIT,              nullptr },
+  { CACHE_SPELL_CRIT_CHANCE,  CACHE_RPPM_CRIT,              nullptr },
+
+  // Aggregate caches
+  { CACHE_AGI_INT,            CACHE_AGILITY,                nullptr },
+  { CACHE_AGI_INT,            CACHE_INTELLECT,              nullptr },
+  { CACHE_STR_AGI,            CACHE_STRENGTH,               nullptr },
+  { CACHE_STR_AGI,            CACHE_AGILITY,                nullptr },
+  { CACHE_STR_INT,            CACHE_STRENGTH,               nullptr },
+  { CACHE_STR_INT,            CACHE_INTELLECT,              nullptr },
+  { CACHE_STR_AGI_INT,        CACHE_STRENGTH,               nullptr },
+  { CACHE_STR_AGI_INT,        CACHE_AGILITY,                nullptr },
+  { CACHE_STR_AGI_INT,        CACHE_INTELLECT,              nullptr },
+  { CACHE_EXP,                CACHE_ATTACK_EXP,             nullptr },
+  { CACHE_EXP,                CACHE_SPELL_HIT,              nullptr },
+  { CACHE_HIT,                CACHE_ATTACK_HIT,             nullptr },
+  { CACHE_HIT,                CACHE_SPELL_HIT,              nullptr },
+  { CACHE_CRIT_CHANCE,        CACHE_ATTACK_CRIT_CHANCE,     nullptr },
+  { CACHE_CRIT_CHANCE,        CACHE_SPELL_CRIT_CHANCE,      nullptr },
+  { CACHE_HASTE,              CACHE_ATTACK_HASTE,           nullptr },
+  { CACHE_HASTE,              CACHE_SPELL_HASTE,            nullptr },
+  { CACHE_VERSATILITY,        CACHE_DAMAGE_VERSATILITY,     nullptr },
+  { CACHE_VERSATILITY,        CACHE_HEAL_VERSATILITY,       nullptr },
+  { CACHE_VERSATILITY,        CACHE_MITIGATION_VERSATILITY, nullptr },
+};
+
+// Dependency edges grouped by the cache they start from
+using stat_cache_dependents_t = std::array<std::vector<const stat_cache_dependency_t*>, CACHE_MAX>;
+
+const stat_cache_dependents_t& stat_cache_dependents()
+{
+  static const stat_cache_dependents_t dependents = [] {
+    stat_cache_dependents_t d;
+    for ( const auto& dependency : stat_cache_dependencies )
+      d[ dependency.from ].push_back( &dependency );
+    return d;
+  }();
+
+  return dependents;
+}
+}  // namespace
+
 /**
  * Invalidate a stat cache, resulting in re-calculation of the composite stat value.
+ *
+ * Caches depending on the invalidated one (see stat_cache_dependencies) are invalidated recursively,
+ * each at most once per invalidation pass.
  */
 void player_t::invalidate_cache( cache_e c )
 {
   if ( !cache.active )
     return;
 
+  if ( !cache.begin_invalidation( c ) )
+    return;
+
   sim->print_debug( "{} invalidates stat cache for {}.", *this, c );
 
-  // Special linked invalidations
-  switch ( c )
+  for ( const auto* dependency : stat_cache_dependents()[ c ] )
   {
-    case CACHE_STRENGTH:
-      if ( current.attack_power_per_strength > 0 )
-        invalidate_cache( CACHE_ATTACK_POWER );
-      if ( current.parry_per_strength > 0 )
-        invalidate_cache( CACHE_PARRY );
-      break;
-
-    case CACHE_AGILITY:
-      if ( current.attack_power_per_agility > 0 )
-        invalidate_cache( CACHE_ATTACK_POWER );
-      if ( current.dodge_per_agility > 0 )
-        invalidate_cache( CACHE_DODGE );
-      if ( current.attack_crit_per_agility > 0 )
-        invalidate_cache( CACHE_ATTACK_CRIT_CHANCE );
-      break;
-
-    case CACHE_INTELLECT:
-      if ( current.spell_power_per_intellect > 0 )
-        invalidate_cache( CACHE_SPELL_POWER );
-      if ( current.spell_crit_per_intellect > 0 )
-        invalidate_cache( CACHE_SPELL_CRIT_CHANCE );
-      break;
-
-    case CACHE_SPELL_POWER:
-      if ( current.attack_power_per_spell_power > 0 )
-        invalidate_cache( CACHE_ATTACK_POWER );
-      break;
-
-    case CACHE_ATTACK_POWER:
-      if ( current.spell_power_per_attack_power > 0 )
-        invalidate_cache( CACHE_SPELL_POWER );
-      break;
-
-    case CACHE_ATTACK_HASTE:
-      invalidate_cache( CACHE_ATTACK_SPEED );
-      invalidate_cache( CACHE_RPPM_HASTE );
-      break;
-
-    case CACHE_SPELL_HASTE:
-      invalidate_cache( CACHE_SPELL_SPEED );
-      invalidate_cache( CACHE_RPPM_HASTE );
-      break;
-
-    case CACHE_BONUS_ARMOR:
-      invalidate_cache( CACHE_ARMOR );
-      break;
-
-    case CACHE_ATTACK_CRIT_CHANCE:
-      invalidate_cache( CACHE_RPPM_CRIT );
-      break;
-
-    case CACHE_SPELL_CRIT_CHANCE:
-      invalidate_cache( CACHE_RPPM_CRIT );
-      break;
-
-    default:
-      break;
+    if ( !dependency->ratio || current.*( dependency->ratio ) > 0 )
+      invalidate_cache( dependency->to );
   }
 
-  // Normal invalidation of the corresponding Cache
-  switch ( c )
-  {
-    case CACHE_EXP:
-      invalidate_cache( CACHE_ATTACK_EXP );
-      invalidate_cache( CACHE_SPELL_HIT );
-      break;
-
-    case CACHE_HIT:
-      invalidate_cache( CACHE_ATTACK_HIT );
-      invalidate_cache( CACHE_SPELL_HIT );
-      break;
-
-    case CACHE_CRIT_CHANCE:
-      invalidate_cache( CACHE_ATTACK_CRIT_CHANCE );
-      invalidate_cache( CACHE_SPELL_CRIT_CHANCE );
-      break;
-
-    case CACHE_HASTE:
-      invalidate_cache( CACHE_ATTACK_HASTE );
-      invalidate_cache( CACHE_SPELL_HASTE );
-      break;
-
-    case CACHE_VERSATILITY:
-      invalidate_cache( CACHE_DAMAGE_VERSATILITY );
-      invalidate_cache( CACHE_HEAL_VERSATILITY );
-      invalidate_cache( CACHE_MITIGATION_VERSATILITY );
-      break;
-
-    default:
-      cache.invalidate( c );
-      break;
-  }
+  cache.end_invalidation();
 }
 #else
 void invalidate_cache( cache_e ) {}
@@ -5453,7 +5441,7 @@ void player_t::sequence_add_wait( timespan_t amount, timespan_t ts )
              collected_data.action_sequence.back().wait_time > timespan_t::zero() )
           collected_data.action_sequence.back().wait_time += amount;
         else
-          collected_data.action_sequence.emplace_back( ts, amount, this );
+          collected_data.action_sequence.add( nullptr, nullptr, ts, amount, this );
       }
     }
     else
@@ -5475,9 +5463,9 @@ void player_t::sequence_add( const action_t* a, const player_t* target, timespan
     if ( collected_data.action_sequence.size() <= sim->expected_max_time() * 2.0 + 3.0 )
     {
       if ( a->is_precombat )
-        collected_data.action_sequence_precombat.emplace_back( a, target, ts, this );
+        collected_data.action_sequence_precombat.add( a, target, ts, timespan_t::zero(), this );
       else
-        collected_data.action_sequence.emplace_back( a, target, ts, this );
+        collected_data.action_sequence.add( a, target, ts, timespan_t::zero(), this );
     }
     else
     {
@@ -5888,6 +5876,20 @@ void merge( player_t& left, player_t& right )
 }
 
 }  // namespace buff_merge
+
+/**
+ * Find the counterpart of list[ idx ] from the other player. Threads create player data in the same
+ * order, so the same position is checked first before falling back to a name lookup.
+ */
+template <typename T>
+T* find_merge_counterpart( const std::vector<T*>& list, const player_t& other, const std::vector<T*>& other_list,
+                           size_t idx, T* ( player_t::*find )( util::string_view ) const )
+{
+  if ( idx < other_list.size() && other_list[ idx ]->name_str == list[ idx ]->name_str )
+    return other_list[ idx ];
+
+  return ( other.*find )( list[ idx ]->name_str );
+}
 }  // namespace
 
 /**
@@ -5913,7 +5915,7 @@ void player_t::merge( player_t& other )
   for ( size_t i = 0; i < proc_list.size(); ++i )
   {
     proc_t& proc = *proc_list[ i ];
-    if ( proc_t* other_proc = other.find_proc( proc.name_str ) )
+    if ( proc_t* other_proc = find_merge_counterpart( proc_list, other, other.proc_list, i, &player_t::find_proc ) )
       proc.merge( *other_proc );
     else
     {
@@ -5927,7 +5929,7 @@ void player_t::merge( player_t& other )
   for ( size_t i = 0; i < gain_list.size(); ++i )
   {
     gain_t& gain = *gain_list[ i ];
-    if ( gain_t* other_gain = other.find_gain( gain.name_str ) )
+    if ( gain_t* other_gain = find_merge_counterpart( gain_list, other, other.gain_list, i, &player_t::find_gain ) )
       gain.merge( *other_gain );
     else
     {
@@ -5941,7 +5943,7 @@ void player_t::merge( player_t& other )
   for ( size_t i = 0; i < stats_list.size(); ++i )
   {
     stats_t& stats = *stats_list[ i ];
-    if ( stats_t* other_stats = other.find_stats( stats.name_str ) )
+    if ( stats_t* other_stats = find_merge_counterpart( stats_list, other, other.stats_list, i, &player_t::find_stats ) )
       stats.merge( *other_stats );
     else
     {
@@ -5955,7 +5957,7 @@ void player_t::merge( player_t& other )
   for ( size_t i = 0; i < uptime_list.size(); ++i )
   {
     uptime_t& uptime = *uptime_list[ i ];
-    if ( uptime_t* other_uptime = other.find_uptime( uptime.name_str ) )
+    if ( uptime_t* other_uptime = find_merge_counterpart( uptime_list, other, other.uptime_list, i, &player_t::find_uptime ) )
       uptime.merge( *other_uptime );
     else
     {
@@ -5969,7 +5971,7 @@ void player_t::merge( player_t& other )
   for ( size_t i = 0; i < benefit_list.size(); ++i )
   {
     benefit_t& benefit = *benefit_list[ i ];
-    if ( benefit_t* other_benefit = other.find_benefit( benefit.name_str ) )
+    if ( benefit_t* other_benefit = find_merge_counterpart( benefit_list, other, other.benefit_list, i, &player_t::find_benefit ) )
       benefit.merge( *other_benefit );
     else
     {
@@ -5983,7 +5985,7 @@ void player_t::merge( player_t& other )
   for ( size_t i = 0; i < sample_data_list.size(); ++i )
   {
     sample_data_helper_t& sd = *sample_data_list[ i ];
-    if ( sample_data_helper_t* other_sd = other.find_sample_data( sd.name_str ) )
+    if ( sample_data_helper_t* other_sd = find_merge_counterpart( sample_data_list, other, other.sample_data_list, i, &player_t::find_sample_data ) )
       sd.merge( *other_sd );
     else
     {
@@ -6026,6 +6028,123 @@ void player_t::merge( player_t& other )
     assert( ours->cd->name_str == theirs->cd->name_str );
     ours->merge( *theirs );
   }
+
+#if defined( SC_STAT_CACHE_COUNTERS )
+  // Stat cache counters
+  cache.merge( other.cache );
+#endif
+}
+
+/**
+ * Reset the buffs triggered or started during the iteration, calling their (possibly overridden)
+ * reset(). Buffs record themselves as dirty when triggered, executed, started or bumped (and when
+ * created), the rest are still in their reset state.
+ *
+ * Dirty buffs are reset in buff_list order, so expire and stack change callbacks see the same state
+ * as with a full reset of the buff_list: a buff triggered by the reset of another buff is reset in
+ * the same pass if it comes later in the buff_list, and stays triggered (and dirty) for the next
+ * iteration otherwise. With verify_reset=1, the full reset is done instead, and every buff that is
+ * not in its reset state when the full reset reaches it without being marked dirty is reported.
+ */
+void player_t::reset_buffs()
+{
+  if ( sim->verify_reset )
+  {
+    for ( auto buff : buff_list )
+    {
+      if ( !buff->dirty && !buff->is_reset() )
+      {
+        sim->error( "{} {} changed state without being marked dirty.", *this, *buff );
+      }
+      buff->dirty = false;
+      buff->reset();
+    }
+
+    // Buffs triggered by the reset of a buff earlier in the list may have been reset afterwards
+    dirty_buff_list.clear();
+    for ( auto buff : buff_list )
+    {
+      if ( buff->dirty )
+        dirty_buff_list.push_back( buff );
+    }
+    return;
+  }
+
+  auto later_in_list = []( const buff_t* l, const buff_t* r ) { return l->reset_index > r->reset_index; };
+
+  reset_buff_queue.swap( dirty_buff_list );
+  dirty_buff_list.clear();
+  range::sort( reset_buff_queue, later_in_list );
+
+  while ( !reset_buff_queue.empty() )
+  {
+    buff_t* buff = reset_buff_queue.back();
+    reset_buff_queue.pop_back();
+
+    size_t n_dirty = dirty_buff_list.size();
+    buff->dirty = false;
+    buff->reset();
+
+    // Buffs triggered by the reset that come later in the buff_list are reset in this pass
+    for ( size_t i = n_dirty; i < dirty_buff_list.size(); )
+    {
+      buff_t* triggered = dirty_buff_list[ i ];
+      if ( triggered->reset_index > buff->reset_index )
+      {
+        reset_buff_queue.insert(
+            std::upper_bound( reset_buff_queue.begin(), reset_buff_queue.end(), triggered, later_in_list ),
+            triggered );
+        dirty_buff_list.erase( dirty_buff_list.begin() + i );
+      }
+      else
+      {
+        ++i;
+      }
+    }
+  }
+}
+
+/**
+ * Reset the cooldowns and dots whose state changed during the iteration. Cooldowns and dots record
+ * themselves as dirty when their state changes (and when created), the rest are still in their reset
+ * state. With verify_reset=1, the recorded state changes are checked against the full list.
+ */
+void player_t::reset_cooldowns_and_dots()
+{
+  if ( sim->verify_reset )
+  {
+    for ( auto cooldown : cooldown_list )
+    {
+      if ( !cooldown->dirty && !cooldown->is_reset() )
+      {
+        sim->error( "{} {} changed state without being marked dirty.", *this, *cooldown );
+        cooldown->mark_dirty();
+      }
+    }
+
+    for ( auto dot : dot_list )
+    {
+      if ( !dot->dirty && !dot->is_reset() )
+      {
+        sim->error( "{} {} changed state without being marked dirty.", *this, *dot );
+        dot->mark_dirty();
+      }
+    }
+  }
+
+  for ( auto cooldown : dirty_cooldown_list )
+  {
+    cooldown->reset_init();
+    cooldown->dirty = false;
+  }
+  dirty_cooldown_list.clear();
+
+  for ( auto dot : dirty_dot_list )
+  {
+    dot->reset();
+    dot->dirty = false;
+  }
+  dirty_dot_list.clear();
 }
 
 /**
@@ -6054,8 +6173,7 @@ void player_t::reset()
 
   sim->print_debug( "{} resets current stats ( reset to initial ): {}", *this, current );
 
-  for ( auto& buff : buff_list )
-    buff->reset();
+  reset_buffs();
 
   last_foreground_action = nullptr;
   prev_gcd_actions.clear();
@@ -6113,12 +6231,10 @@ void player_t::reset()
 
   range::for_each( action_list, []( action_t* action ) { action->reset(); } );
 
-  range::for_each( cooldown_list, []( cooldown_t* cooldown ) { cooldown->reset_init(); } );
+  reset_cooldowns_and_dots();
 
   range::for_each( target_specific_cooldown_list, []( target_specific_cooldown_t* tcd ) { tcd->reset(); } );
 
-  range::for_each( dot_list, []( dot_t* dot ) { dot->reset(); } );
-
   range::for_each( stats_list, []( stats_t* stat ) { stat->reset(); } );
 
   range::for_each( uptime_list, []( uptime_t* uptime ) { uptime->reset(); } );
@@ -7959,7 +8075,7 @@ void player_t::assess_heal( school_e, result_amount_type, action_state_t* s )
 
 void player_t::trigger_callbacks( proc_types type, proc_types2 type2, action_t* action, action_state_t* state )
 {
-  action_callback_t::trigger( callbacks.procs[ type ][ type2 ], action, state );
+  callbacks.trigger( callbacks.procs[ type ][ type2 ], action, state );
 }
 
 void player_t::summon_pet( util::string_view pet_name, const timespan_t duration )
@@ -8053,12 +8169,12 @@ stats_t* player_t::find_stats( util::string_view name ) const
 
 gain_t* player_t::find_gain( util::string_view name ) const
 {
-  return find_vector_member( gain_list, name );
+  return gain_name_index.find( name );
 }
 
 proc_t* player_t::find_proc( util::string_view name ) const
 {
-  return find_vector_member( proc_list, name );
+  return proc_name_index.find( name );
 }
 
 sample_data_helper_t* player_t::find_sample_data( util::string_view name ) const
@@ -8078,7 +8194,7 @@ uptime_t* player_t::find_uptime( util::string_view name ) const
 
 cooldown_t* player_t::find_cooldown( util::string_view name ) const
 {
-  return find_vector_member( cooldown_list, name );
+  return cooldown_name_index.find( name );
 }
 
 target_specific_cooldown_t* player_t::find_target_specific_cooldown( util::string_view name ) const
@@ -8100,6 +8216,8 @@ cooldown_t* player_t::get_cooldown( util::string_view name, action_t* a )
     c = new cooldown_t( name, *this );
 
     cooldown_list.push_back( c );
+    cooldown_name_index.add( c );
+    dirty_cooldown_list.push_back( c );
   }
 
   if ( a )
@@ -8196,6 +8314,7 @@ dot_t* player_t::get_dot( util::string_view name, player_t* source )
   {
     d = new dot_t( name, this, source );
     dot_list.push_back( d );
+    dirty_dot_list.push_back( d );
   }
 
   return d;
@@ -8210,6 +8329,7 @@ gain_t* player_t::get_gain( util::string_view name )
     g = new gain_t( name );
 
     gain_list.push_back( g );
+    gain_name_index.add( g );
   }
 
   return g;
@@ -8224,6 +8344,7 @@ proc_t* player_t::get_proc( util::string_view name )
     p = new proc_t( *sim, name );
 
     proc_list.push_back( p );
+    proc_name_index.add( p );
   }
 
   return p;
@@ -11684,7 +11805,7 @@ std::unique_ptr<expr_t> player_t::create_expression( util::string_view expressio
     {
       // buff.buff_name.buff_property
       get_target_data( this );
-      buff_t* buff = buff_t::find_expressable( buff_list, splits[ 1 ], this );
+      buff_t* buff = buff_t::find_expressable( this, splits[ 1 ], this );
       if ( !buff )
         buff = buff_t::find( this, splits[ 1 ], this );  // Raid debuffs & fallback buffs
       if ( buff )
@@ -13080,6 +13201,7 @@ void player_t::analyze( sim_t& s )
 
   if ( !quiet && !is_enemy() && !is_add() && !( is_pet() && s.report_pets_separately ) )
   {
+    AUTO_LOCK( s.analyze_mutex );
     s.players_by_dps.push_back( this );
     s.players_by_priority_dps.push_back( this );
     s.players_by_hps.push_back( this );
@@ -13093,6 +13215,7 @@ void player_t::analyze( sim_t& s )
 
   if ( !quiet && ( is_enemy() || is_add() ) && !( is_pet() && s.report_pets_separately ) )
   {
+    AUTO_LOCK( s.analyze_mutex );
     s.targets_by_name.push_back( this );
   }
 
@@ -13345,12 +13468,23 @@ void player_t::check_resource_change_for_callback(resource_e resource, double pr
 
 rng::rng_t& player_t::rng()
 {
-  return sim -> rng();
+  return actor_rng ? *actor_rng : sim -> rng();
 }
 
 rng::rng_t& player_t::rng() const
 {
-  return sim -> rng();
+  return actor_rng ? *actor_rng : sim -> rng();
+}
+
+void player_t::seed_rng( uint64_t seed )
+{
+  if ( !actor_rng )
+  {
+    actor_rng = std::make_unique<rng::rng_t>();
+  }
+
+  actor_rng->seed( seed );
+  actor_rng->reset();
 }
 
 timespan_t player_t::time_to_move() const
@@ -13459,18 +13593,58 @@ void player_t::do_update_movement( double yards )
   }
 }
 
-player_collected_data_t::action_sequence_data_t::action_sequence_data_t( const action_t* a, const player_t* t,
-                                                                         timespan_t ts, timespan_t wait,
-                                                                         const player_t* p )
-  : action( a ), target( t ), target_name( t ? t->name_str : "" ), time( ts ), wait_time( wait ), queue_failed( false )
+util::string_view player_collected_data_t::action_sequence_data_t::target_name() const
+{
+  return target ? util::string_view( target->name_str ) : util::string_view();
+}
+
+util::span<const player_collected_data_t::action_sequence_data_t::record_t<buff_t>>
+player_collected_data_t::action_sequence_data_t::buff_list() const
+{
+  return { sequence->buff_records.data() + buff_begin, buff_end - buff_begin };
+}
+
+util::span<const player_collected_data_t::action_sequence_data_t::record_t<cooldown_t>>
+player_collected_data_t::action_sequence_data_t::cooldown_list() const
+{
+  return { sequence->cooldown_records.data() + cooldown_begin, cooldown_end - cooldown_begin };
+}
+
+util::span<const player_collected_data_t::action_sequence_data_t::target_record_t>
+player_collected_data_t::action_sequence_data_t::target_list() const
+{
+  return { sequence->target_records.data() + target_begin, target_end - target_begin };
+}
+
+util::span<const player_collected_data_t::action_sequence_data_t::record_t<buff_t>>
+player_collected_data_t::action_sequence_data_t::debuff_list( const target_record_t& t ) const
+{
+  return { sequence->debuff_records.data() + t.debuff_begin, t.debuff_end - t.debuff_begin };
+}
+
+void player_collected_data_t::action_sequence_t::add( const action_t* a, const player_t* t, timespan_t ts,
+                                                      timespan_t wait, const player_t* p )
 {
+  auto& entry = entries.emplace_back();
+  entry.action = a;
+  entry.target = t;
+  entry.time = ts;
+  entry.wait_time = wait;
+  entry.queue_failed = false;
+  entry.sequence = this;
+
+  entry.buff_begin = as<uint32_t>( buff_records.size() );
   for ( buff_t* b : p->buff_list )
   {
     if ( b->check() && !b->quiet && !b->constant )
     {
-      buff_list.emplace_back( b, b->check(), b->remains() );
+      buff_records.emplace_back( b, b->check(), b->remains() );
     }
   }
+  entry.buff_end = as<uint32_t>( buff_records.size() );
+
+  entry.cooldown_begin = as<uint32_t>( cooldown_records.size() );
+  entry.target_begin = as<uint32_t>( target_records.size() );
 
   // Adding cooldown and debuffs snapshots if asking for json full states
   if ( p->sim->json_full_states )
@@ -13479,36 +13653,55 @@ player_collected_data_t::action_sequence_data_t::action_sequence_data_t( const a
     {
       if ( c->down() )
       {
-        cooldown_list.emplace_back( c, c->charges, c->remains() );
+        cooldown_records.emplace_back( c, c->charges, c->remains() );
       }
     }
     for ( player_t* current_target : p->sim->target_list )
     {
-      decltype(target_list)::value_type::second_type debuff_list;
+      auto debuff_begin = as<uint32_t>( debuff_records.size() );
       for ( buff_t* d : current_target->buff_list )
       {
         if ( d->check() && !d->quiet && !d->constant )
         {
-          debuff_list.emplace_back( d, d->check(), d->remains() );
+          debuff_records.emplace_back( d, d->check(), d->remains() );
         }
       }
-      target_list.emplace_back( current_target, std::move( debuff_list ) );
+      target_records.push_back( { current_target, debuff_begin, as<uint32_t>( debuff_records.size() ) } );
     }
   }
 
-  range::fill( resource_snapshot, -1 );
-  range::fill( resource_max_snapshot, -1 );
+  entry.cooldown_end = as<uint32_t>( cooldown_records.size() );
+  entry.target_end = as<uint32_t>( target_records.size() );
+
+  range::fill( entry.resource_snapshot, -1 );
+  range::fill( entry.resource_max_snapshot, -1 );
 
   for ( resource_e i = RESOURCE_HEALTH; i < RESOURCE_MAX; ++i )
   {
     if ( p->resources.max[ i ] > 0.0 )
     {
-      resource_snapshot[ i ]     = p->resources.current[ i ];
-      resource_max_snapshot[ i ] = p->resources.max[ i ];
+      entry.resource_snapshot[ i ]     = p->resources.current[ i ];
+      entry.resource_max_snapshot[ i ] = p->resources.max[ i ];
     }
   }
 }
 
+void player_collected_data_t::action_sequence_t::reserve( size_t n )
+{
+  entries.reserve( n );
+  // Typically a handful of buffs are up for each recorded action
+  buff_records.reserve( n * 8 );
+}
+
+void player_collected_data_t::action_sequence_t::clear()
+{
+  entries.clear();
+  buff_records.clear();
+  debuff_records.clear();
+  cooldown_records.clear();
+  target_records.clear();
+}
+
 player_collected_data_t::player_collected_data_t( const player_t* player ) :
   fight_length( player->name_str + " Fight Length", generic_container_type( player, 2 ) ),
   waiting_time( player->name_str + " Waiting Time", generic_container_type( player, 2 ) ),
@@ -13569,6 +13762,19 @@ player_collected_data_t::player_collected_data_t( const player_t* player ) :
 
 void player_collected_data_t::reserve_memory( const player_t& p )
 {
+  // Fight length samples are needed as-is to adjust timelines, so they are never sketched
+  if ( p.sim->statistics_sketch_accuracy > 0 )
+  {
+    for ( extended_sample_data_t* sd : { &waiting_time, &pooling_time, &executed_foreground_actions, &dmg,
+                                         &compound_dmg, &prioritydps, &dps, &dpse, &dtps, &dmg_taken, &heal,
+                                         &compound_heal, &hps, &hpse, &htps, &heal_taken, &absorb, &compound_absorb,
+                                         &aps, &atps, &absorb_taken, &deaths, &theck_meloree_index,
+                                         &effective_theck_meloree_index, &max_spike_amount, &target_metric } )
+    {
+      sd->enable_sketch( p.sim->statistics_sketch_accuracy );
+    }
+  }
+
   unsigned size = std::min( as<unsigned>( p.sim->iterations ), 2048U );
   fight_length.reserve( size );
   // DMG
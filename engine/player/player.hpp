@@ -17,6 +17,7 @@
 #include "player_processed_report_information.hpp"
 #include "player_stat_cache.hpp"
 #include "util/cache.hpp"
+#include "util/name_index.hpp"
 #include "dbc/specialization.hpp"
 #include "assessor.hpp"
 #include "talent.hpp"
@@ -312,6 +313,12 @@ struct player_t : public actor_t
   std::string use_apl;
   bool use_default_action_list;
   auto_dispose< std::vector<dot_t*> > dot_list;
+  /// Dots (on this actor), cooldowns and buffs whose state changed since the last reset
+  std::vector<dot_t*> dirty_dot_list;
+  std::vector<cooldown_t*> dirty_cooldown_list;
+  std::vector<buff_t*> dirty_buff_list;
+  /// Dirty buffs left to reset in player_t::reset_buffs(), in reverse buff_list order
+  std::vector<buff_t*> reset_buff_queue;
   auto_dispose< std::vector<action_priority_list_t*> > action_priority_list;
   std::vector<action_t*> precombat_action_list;
   action_priority_list_t* active_action_list;
@@ -350,17 +357,23 @@ struct player_t : public actor_t
   double tmi_window;
 
   auto_dispose<std::vector<buff_t*>> buff_list;
+  name_index_t<buff_t> buff_name_index;
   // buff_t::find( player, name, source ) will return pointer to sim.auras.fallback
   std::vector<std::pair<std::string, player_t*>> fallback_buff_names;
   auto_dispose<std::vector<proc_t*>> proc_list;
+  name_index_t<proc_t> proc_name_index;
   auto_dispose<std::vector<gain_t*>> gain_list;
+  name_index_t<gain_t> gain_name_index;
   auto_dispose<std::vector<stats_t*>> stats_list;
   auto_dispose<std::vector<benefit_t*>> benefit_list;
   auto_dispose<std::vector<uptime_t*>> uptime_list;
   auto_dispose<std::vector<cooldown_t*>> cooldown_list;
+  name_index_t<cooldown_t> cooldown_name_index;
   auto_dispose<std::vector<target_specific_cooldown_t*>> target_specific_cooldown_list;
   auto_dispose<std::vector<real_ppm_t*>> rppm_list;
   auto_dispose<std::vector<shuffled_rng_t*>> shuffled_rng_list;
+  // Random number stream of the actor, only used with common random numbers (see sim_t::seed_iteration)
+  std::unique_ptr<rng::rng_t> actor_rng;
   std::vector<cooldown_t*> dynamic_cooldown_list;
   std::array<std::vector<plot_data_t>, STAT_MAX> dps_plot_data;
   std::vector<std::vector<plot_data_t>> reforge_plot_data;
@@ -1039,6 +1052,8 @@ public:
   virtual void action_init_finished(action_t&);
   virtual bool verify_use_items() const;
   virtual void reset();
+  void reset_buffs();
+  void reset_cooldowns_and_dots();
   virtual void combat_begin();
   virtual void combat_end();
   virtual void precombat_init();
@@ -1285,6 +1300,7 @@ public:
 
   rng::rng_t& rng();
   rng::rng_t& rng() const;
+  void seed_rng( uint64_t seed );
   virtual timespan_t time_to_move() const;
   virtual void trigger_movement( double distance, movement_direction_type);
   virtual void update_movement( timespan_t duration );
@@ -9,8 +9,13 @@
 #include "util/sample_data.hpp"
 #include "util/timeline.hpp"
 #include "util/concurrency.hpp"
+#include "util/span.hpp"
+#include "util/string_view.hpp"
 #include "sc_enums.hpp"
 
+#include <array>
+#include <cstdint>
+
 struct action_t;
 struct buff_t;
 struct cooldown_t;
@@ -121,7 +126,9 @@ struct player_collected_data_t
   // used.
   int total_iterations;
 
-  struct action_sequence_data_t : noncopyable
+  struct action_sequence_t;
+
+  struct action_sequence_data_t
   {
     template <typename T>
     struct record_t {
@@ -133,27 +140,81 @@ struct player_collected_data_t
         : object( o ), value( v ), time_value( tv ) {}
     };
 
+    // Debuffs of a target, stored in the debuff records of the sequence
+    struct target_record_t
+    {
+      player_t* target;
+      uint32_t debuff_begin, debuff_end;
+    };
+
     const action_t* action;
     const player_t* target;
-    std::string target_name;
-    const timespan_t time;
+    timespan_t time;
     timespan_t wait_time;
     bool queue_failed;
-    std::vector< record_t<buff_t> > buff_list;
-    std::vector< record_t<cooldown_t> > cooldown_list;
-    std::vector< std::pair<player_t*, std::vector< record_t<buff_t> > > > target_list;
     std::array<double, RESOURCE_MAX> resource_snapshot;
     std::array<double, RESOURCE_MAX> resource_max_snapshot;
 
-    action_sequence_data_t( const action_t* a, const player_t* t, timespan_t ts, timespan_t wait, const player_t* p );
+    util::string_view target_name() const;
+    util::span<const record_t<buff_t>> buff_list() const;
+    util::span<const record_t<cooldown_t>> cooldown_list() const;
+    util::span<const target_record_t> target_list() const;
+    util::span<const record_t<buff_t>> debuff_list( const target_record_t& ) const;
+
+  private:
+    friend struct action_sequence_t;
+
+    const action_sequence_t* sequence;
+    uint32_t buff_begin, buff_end;
+    uint32_t cooldown_begin, cooldown_end;
+    uint32_t target_begin, target_end;
+  };
+
+  /* Action sequence of the sample iteration. The buff, cooldown and target debuff snapshots of all
+   * entries are stored in record arenas of the sequence, which keep their capacity when cleared, so
+   * recording an action does not allocate once the sequence has been reserved (or grown).
+   */
+  struct action_sequence_t : nonmoveable
+  {
+  private:
+    friend struct action_sequence_data_t;
+
+    std::vector<action_sequence_data_t> entries;
+    std::vector<action_sequence_data_t::record_t<buff_t>> buff_records, debuff_records;
+    std::vector<action_sequence_data_t::record_t<cooldown_t>> cooldown_records;
+    std::vector<action_sequence_data_t::target_record_t> target_records;
+
+  public:
+    // Add an entry for an action (or a wait, when a is nullptr), snapshotting the state of actor p
+    void add( const action_t* a, const player_t* t, timespan_t ts, timespan_t wait, const player_t* p );
+
+    void reserve( size_t n );
+    void clear();
+
+    bool empty() const
+    { return entries.empty(); }
+
+    size_t size() const
+    { return entries.size(); }
 
-    action_sequence_data_t( timespan_t ts, timespan_t wait, const player_t* p )
-      : action_sequence_data_t( nullptr, nullptr, ts, wait, p ) {}
-    action_sequence_data_t( const action_t* a, const player_t* t, timespan_t ts, const player_t* p )
-      : action_sequence_data_t( a, t, ts, timespan_t::zero(), p ) {}
+    action_sequence_data_t& back()
+    { return entries.back(); }
+
+    auto begin() const
+    { return entries.cbegin(); }
+
+    auto end() const
+    { return entries.cend(); }
+
+    auto rbegin()
+    { return entries.rbegin(); }
+
+    auto rend()
+    { return entries.rend(); }
   };
-  std::vector<action_sequence_data_t> action_sequence;
-  std::vector<action_sequence_data_t> action_sequence_precombat;
+
+  action_sequence_t action_sequence;
+  action_sequence_t action_sequence_precombat;
 
   // Buffed snapshot_stats (for reporting)
   struct buffed_stats_t
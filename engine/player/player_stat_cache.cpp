@@ -9,6 +9,25 @@
 #include "action/action.hpp"
 
 
+player_stat_cache_t::player_stat_cache_t( const player_t* p )
+  : player( p ),
+    generation( 1 ),
+    all_invalidated( 1 ),
+    invalidated(),
+    pass_generation( 0 ),
+    pass_depth( 0 ),
+    computed(),
+    spell_power_computed(),
+    player_mult_computed(),
+    player_heal_mult_computed(),
+    weapon_attack_power_computed(),
+#if defined( SC_STAT_CACHE_COUNTERS )
+    counters(),
+#endif
+    active( false )
+{
+}
+
 /**
  * Invalidate cache for ALL stats.
  */
@@ -17,11 +36,7 @@ void player_stat_cache_t::invalidate_all()
   if ( !active )
     return;
 
-  range::fill( valid, false );
-  range::fill( spell_power_valid, false );
-  range::fill( player_mult_valid, false );
-  range::fill( player_heal_mult_valid, false );
-  range::fill( weapon_attack_power_valid, false );
+  all_invalidated = ++generation;
 }
 
 /**
@@ -29,29 +44,43 @@ void player_stat_cache_t::invalidate_all()
  */
 void player_stat_cache_t::invalidate( cache_e c )
 {
-  switch ( c )
-  {
-    case CACHE_SPELL_POWER:
-      range::fill( spell_power_valid, false );
-      break;
-
-    case CACHE_WEAPON_DPS:
-      range::fill( weapon_attack_power_valid, false );
-      break;
+  invalidated[ c ] = ++generation;
+#if defined( SC_STAT_CACHE_COUNTERS )
+  ++counters[ c ].invalidations;
+#endif
+}
 
-    case CACHE_PLAYER_DAMAGE_MULTIPLIER:
-      range::fill( player_mult_valid, false );
-      break;
+/**
+ * Invalidate a cache as part of an invalidation pass (see player_t::invalidate_cache), unless it was
+ * already invalidated earlier in the same pass.
+ */
+bool player_stat_cache_t::begin_invalidation( cache_e c )
+{
+  if ( pass_depth == 0 )
+    pass_generation = generation;
+  else if ( invalidated[ c ] > pass_generation )
+  {
+#if defined( SC_STAT_CACHE_COUNTERS )
+    ++counters[ c ].skipped;
+#endif
+    return false;
+  }
 
-    case CACHE_PLAYER_HEAL_MULTIPLIER:
-      range::fill( player_heal_mult_valid, false );
-      break;
+  invalidate( c );
+  ++pass_depth;
+  return true;
+}
 
-    default:
-      valid[ c ] = false;
-      break;
-  }
+#if defined( SC_STAT_CACHE_COUNTERS )
+/**
+ * Merge cache counters with the same player from another thread.
+ */
+void player_stat_cache_t::merge( const player_stat_cache_t& other )
+{
+  for ( size_t i = 0; i < counters.size(); ++i )
+    counters[ i ].merge( other.counters[ i ] );
 }
+#endif
 
 /**
  * Get access attribute cache functions by attribute-enumeration.
@@ -81,9 +110,8 @@ double player_stat_cache_t::get_attribute( attribute_e a ) const
 
 double player_stat_cache_t::strength() const
 {
-  if ( !active || !valid[ CACHE_STRENGTH ] )
+  if ( !check( CACHE_STRENGTH ) )
   {
-    valid[ CACHE_STRENGTH ] = true;
     _strength               = player->strength();
   }
   else
@@ -93,9 +121,8 @@ double player_stat_cache_t::strength() const
 
 double player_stat_cache_t::agility() const
 {
-  if ( !active || !valid[ CACHE_AGILITY ] )
+  if ( !check( CACHE_AGILITY ) )
   {
-    valid[ CACHE_AGILITY ] = true;
     _agility               = player->agility();
   }
   else
@@ -105,9 +132,8 @@ double player_stat_cache_t::agility() const
 
 double player_stat_cache_t::stamina() const
 {
-  if ( !active || !valid[ CACHE_STAMINA ] )
+  if ( !check( CACHE_STAMINA ) )
   {
-    valid[ CACHE_STAMINA ] = true;
     _stamina               = player->stamina();
   }
   else
@@ -117,9 +143,8 @@ double player_stat_cache_t::stamina() const
 
 double player_stat_cache_t::intellect() const
 {
-  if ( !active || !valid[ CACHE_INTELLECT ] )
+  if ( !check( CACHE_INTELLECT ) )
   {
-    valid[ CACHE_INTELLECT ] = true;
     _intellect               = player->intellect();
   }
   else
@@ -129,9 +154,8 @@ double player_stat_cache_t::intellect() const
 
 double player_stat_cache_t::spirit() const
 {
-  if ( !active || !valid[ CACHE_SPIRIT ] )
+  if ( !check( CACHE_SPIRIT ) )
   {
-    valid[ CACHE_SPIRIT ] = true;
     _spirit               = player->spirit();
   }
   else
@@ -141,9 +165,8 @@ double player_stat_cache_t::spirit() const
 
 double player_stat_cache_t::spell_power( school_e s ) const
 {
-  if ( !active || !spell_power_valid[ s ] )
+  if ( !check( CACHE_SPELL_POWER, spell_power_computed[ s ] ) )
   {
-    spell_power_valid[ s ] = true;
     _spell_power[ s ]      = player->composite_spell_power( s );
   }
   else
@@ -153,9 +176,8 @@ double player_stat_cache_t::spell_power( school_e s ) const
 
 double player_stat_cache_t::attack_power() const
 {
-  if ( !active || !valid[ CACHE_ATTACK_POWER ] )
+  if ( !check( CACHE_ATTACK_POWER ) )
   {
-    valid[ CACHE_ATTACK_POWER ] = true;
     _attack_power               = player->composite_melee_attack_power();
   }
   else
@@ -167,9 +189,8 @@ double player_stat_cache_t::weapon_attack_power( attack_power_type t ) const
 {
   auto type = static_cast<unsigned>( t );
 
-  if ( !active || !weapon_attack_power_valid[ type ] )
+  if ( !check( CACHE_WEAPON_DPS, weapon_attack_power_computed[ type ] ) )
   {
-    weapon_attack_power_valid[ type ] = true;
     _weapon_attack_power[ type ] = player->composite_weapon_attack_power_by_type( t );
   }
   else
@@ -179,9 +200,8 @@ double player_stat_cache_t::weapon_attack_power( attack_power_type t ) const
 
 double player_stat_cache_t::attack_expertise() const
 {
-  if ( !active || !valid[ CACHE_ATTACK_EXP ] )
+  if ( !check( CACHE_ATTACK_EXP ) )
   {
-    valid[ CACHE_ATTACK_EXP ] = true;
     _attack_expertise         = player->composite_melee_expertise();
   }
   else
@@ -191,9 +211,8 @@ double player_stat_cache_t::attack_expertise() const
 
 double player_stat_cache_t::attack_hit() const
 {
-  if ( !active || !valid[ CACHE_ATTACK_HIT ] )
+  if ( !check( CACHE_ATTACK_HIT ) )
   {
-    valid[ CACHE_ATTACK_HIT ] = true;
     _attack_hit               = player->composite_melee_hit();
   }
   else
@@ -209,9 +228,8 @@ double player_stat_cache_t::attack_hit() const
 
 double player_stat_cache_t::attack_crit_chance() const
 {
-  if ( !active || !valid[ CACHE_ATTACK_CRIT_CHANCE ] )
+  if ( !check( CACHE_ATTACK_CRIT_CHANCE ) )
   {
-    valid[ CACHE_ATTACK_CRIT_CHANCE ] = true;
     _attack_crit_chance               = player->composite_melee_crit_chance();
   }
   else
@@ -221,9 +239,8 @@ double player_stat_cache_t::attack_crit_chance() const
 
 double player_stat_cache_t::attack_haste() const
 {
-  if ( !active || !valid[ CACHE_ATTACK_HASTE ] )
+  if ( !check( CACHE_ATTACK_HASTE ) )
   {
-    valid[ CACHE_ATTACK_HASTE ] = true;
     _attack_haste               = player->composite_melee_haste();
   }
   else
@@ -233,9 +250,8 @@ double player_stat_cache_t::attack_haste() const
 
 double player_stat_cache_t::attack_speed() const
 {
-  if ( !active || !valid[ CACHE_ATTACK_SPEED ] )
+  if ( !check( CACHE_ATTACK_SPEED ) )
   {
-    valid[ CACHE_ATTACK_SPEED ] = true;
     _attack_speed               = player->composite_melee_speed();
   }
   else
@@ -245,9 +261,8 @@ double player_stat_cache_t::attack_speed() const
 
 double player_stat_cache_t::spell_hit() const
 {
-  if ( !active || !valid[ CACHE_SPELL_HIT ] )
+  if ( !check( CACHE_SPELL_HIT ) )
   {
-    valid[ CACHE_SPELL_HIT ] = true;
     _spell_hit               = player->composite_spell_hit();
   }
   else
@@ -257,9 +272,8 @@ double player_stat_cache_t::spell_hit() const
 
 double player_stat_cache_t::spell_crit_chance() const
 {
-  if ( !active || !valid[ CACHE_SPELL_CRIT_CHANCE ] )
+  if ( !check( CACHE_SPELL_CRIT_CHANCE ) )
   {
-    valid[ CACHE_SPELL_CRIT_CHANCE ] = true;
     _spell_crit_chance               = player->composite_spell_crit_chance();
   }
   else
@@ -269,9 +283,8 @@ double player_stat_cache_t::spell_crit_chance() const
 
 double player_stat_cache_t::rppm_haste_coeff() const
 {
-  if ( !active || !valid[ CACHE_RPPM_HASTE ] )
+  if ( !check( CACHE_RPPM_HASTE ) )
   {
-    valid[ CACHE_RPPM_HASTE ] = true;
     _rppm_haste_coeff          = 1.0 / std::min( player->cache.spell_haste(), player->cache.attack_haste() );
   }
   else
@@ -283,9 +296,8 @@ double player_stat_cache_t::rppm_haste_coeff() const
 
 double player_stat_cache_t::rppm_crit_coeff() const
 {
-  if ( !active || !valid[ CACHE_RPPM_CRIT ] )
+  if ( !check( CACHE_RPPM_CRIT ) )
   {
-    valid[ CACHE_RPPM_CRIT ] = true;
     _rppm_crit_coeff          = 1.0 + std::max( player->cache.attack_crit_chance(), player->cache.spell_crit_chance() );
   }
   else
@@ -297,9 +309,8 @@ double player_stat_cache_t::rppm_crit_coeff() const
 
 double player_stat_cache_t::spell_haste() const
 {
-  if ( !active || !valid[ CACHE_SPELL_HASTE ] )
+  if ( !check( CACHE_SPELL_HASTE ) )
   {
-    valid[ CACHE_SPELL_HASTE ] = true;
     _spell_haste               = player->composite_spell_haste();
   }
   else
@@ -309,9 +320,8 @@ double player_stat_cache_t::spell_haste() const
 
 double player_stat_cache_t::spell_speed() const
 {
-  if ( !active || !valid[ CACHE_SPELL_SPEED ] )
+  if ( !check( CACHE_SPELL_SPEED ) )
   {
-    valid[ CACHE_SPELL_SPEED ] = true;
     _spell_speed               = player->composite_spell_speed();
   }
   else
@@ -321,9 +331,8 @@ double player_stat_cache_t::spell_speed() const
 
 double player_stat_cache_t::dodge() const
 {
-  if ( !active || !valid[ CACHE_DODGE ] )
+  if ( !check( CACHE_DODGE ) )
   {
-    valid[ CACHE_DODGE ] = true;
     _dodge               = player->composite_dodge();
   }
   else
@@ -333,9 +342,8 @@ double player_stat_cache_t::dodge() const
 
 double player_stat_cache_t::parry() const
 {
-  if ( !active || !valid[ CACHE_PARRY ] )
+  if ( !check( CACHE_PARRY ) )
   {
-    valid[ CACHE_PARRY ] = true;
     _parry               = player->composite_parry();
   }
   else
@@ -345,9 +353,8 @@ double player_stat_cache_t::parry() const
 
 double player_stat_cache_t::block() const
 {
-  if ( !active || !valid[ CACHE_BLOCK ] )
+  if ( !check( CACHE_BLOCK ) )
   {
-    valid[ CACHE_BLOCK ] = true;
     _block               = player->composite_block();
   }
   else
@@ -357,9 +364,8 @@ double player_stat_cache_t::block() const
 
 double player_stat_cache_t::crit_block() const
 {
-  if ( !active || !valid[ CACHE_CRIT_BLOCK ] )
+  if ( !check( CACHE_CRIT_BLOCK ) )
   {
-    valid[ CACHE_CRIT_BLOCK ] = true;
     _crit_block               = player->composite_crit_block();
   }
   else
@@ -369,9 +375,8 @@ double player_stat_cache_t::crit_block() const
 
 double player_stat_cache_t::crit_avoidance() const
 {
-  if ( !active || !valid[ CACHE_CRIT_AVOIDANCE ] )
+  if ( !check( CACHE_CRIT_AVOIDANCE ) )
   {
-    valid[ CACHE_CRIT_AVOIDANCE ] = true;
     _crit_avoidance               = player->composite_crit_avoidance();
   }
   else
@@ -381,9 +386,8 @@ double player_stat_cache_t::crit_avoidance() const
 
 double player_stat_cache_t::miss() const
 {
-  if ( !active || !valid[ CACHE_MISS ] )
+  if ( !check( CACHE_MISS ) )
   {
-    valid[ CACHE_MISS ] = true;
     _miss               = player->composite_miss();
   }
   else
@@ -393,9 +397,8 @@ double player_stat_cache_t::miss() const
 
 double player_stat_cache_t::armor() const
 {
-  if ( !active || !valid[ CACHE_ARMOR ] || !valid[ CACHE_BONUS_ARMOR ] )
+  if ( !check( CACHE_ARMOR ) )
   {
-    valid[ CACHE_ARMOR ] = true;
     _armor               = player->composite_armor();
   }
   else
@@ -405,9 +408,8 @@ double player_stat_cache_t::armor() const
 
 double player_stat_cache_t::mastery() const
 {
-  if ( !active || !valid[ CACHE_MASTERY ] )
+  if ( !check( CACHE_MASTERY ) )
   {
-    valid[ CACHE_MASTERY ] = true;
     _mastery               = player->composite_mastery();
     _mastery_value         = player->composite_mastery_value();
   }
@@ -423,9 +425,8 @@ double player_stat_cache_t::mastery() const
  */
 double player_stat_cache_t::mastery_value() const
 {
-  if ( !active || !valid[ CACHE_MASTERY ] )
+  if ( !check( CACHE_MASTERY ) )
   {
-    valid[ CACHE_MASTERY ] = true;
     _mastery               = player->composite_mastery();
     _mastery_value         = player->composite_mastery_value();
   }
@@ -436,9 +437,8 @@ double player_stat_cache_t::mastery_value() const
 
 double player_stat_cache_t::bonus_armor() const
 {
-  if ( !active || !valid[ CACHE_BONUS_ARMOR ] )
+  if ( !check( CACHE_BONUS_ARMOR ) )
   {
-    valid[ CACHE_BONUS_ARMOR ] = true;
     _bonus_armor               = player->composite_bonus_armor();
   }
   else
@@ -448,9 +448,8 @@ double player_stat_cache_t::bonus_armor() const
 
 double player_stat_cache_t::damage_versatility() const
 {
-  if ( !active || !valid[ CACHE_DAMAGE_VERSATILITY ] )
+  if ( !check( CACHE_DAMAGE_VERSATILITY ) )
   {
-    valid[ CACHE_DAMAGE_VERSATILITY ] = true;
     _damage_versatility               = player->composite_damage_versatility();
   }
   else
@@ -460,9 +459,8 @@ double player_stat_cache_t::damage_versatility() const
 
 double player_stat_cache_t::heal_versatility() const
 {
-  if ( !active || !valid[ CACHE_HEAL_VERSATILITY ] )
+  if ( !check( CACHE_HEAL_VERSATILITY ) )
   {
-    valid[ CACHE_HEAL_VERSATILITY ] = true;
     _heal_versatility               = player->composite_heal_versatility();
   }
   else
@@ -472,9 +470,8 @@ double player_stat_cache_t::heal_versatility() const
 
 double player_stat_cache_t::mitigation_versatility() const
 {
-  if ( !active || !valid[ CACHE_MITIGATION_VERSATILITY ] )
+  if ( !check( CACHE_MITIGATION_VERSATILITY ) )
   {
-    valid[ CACHE_MITIGATION_VERSATILITY ] = true;
     _mitigation_versatility               = player->composite_mitigation_versatility();
   }
   else
@@ -484,9 +481,8 @@ double player_stat_cache_t::mitigation_versatility() const
 
 double player_stat_cache_t::leech() const
 {
-  if ( !active || !valid[ CACHE_LEECH ] )
+  if ( !check( CACHE_LEECH ) )
   {
-    valid[ CACHE_LEECH ] = true;
     _leech               = player->composite_leech();
   }
   else
@@ -496,9 +492,8 @@ double player_stat_cache_t::leech() const
 
 double player_stat_cache_t::run_speed() const
 {
-  if ( !active || !valid[ CACHE_RUN_SPEED ] )
+  if ( !check( CACHE_RUN_SPEED ) )
   {
-    valid[ CACHE_RUN_SPEED ] = true;
     _run_speed               = player->composite_movement_speed();
   }
   else
@@ -508,9 +503,8 @@ double player_stat_cache_t::run_speed() const
 
 double player_stat_cache_t::avoidance() const
 {
-  if ( !active || !valid[ CACHE_AVOIDANCE ] )
+  if ( !check( CACHE_AVOIDANCE ) )
   {
-    valid[ CACHE_AVOIDANCE ] = true;
     _avoidance               = player->composite_avoidance();
   }
   else
@@ -520,9 +514,8 @@ double player_stat_cache_t::avoidance() const
 
 double player_stat_cache_t::corruption() const
 {
-  if ( !active || !valid[ CACHE_CORRUPTION ] )
+  if ( !check( CACHE_CORRUPTION ) )
   {
-    valid[ CACHE_CORRUPTION ] = true;
     _corruption               = player->composite_corruption();
   }
   else
@@ -532,9 +525,8 @@ double player_stat_cache_t::corruption() const
 
 double player_stat_cache_t::corruption_resistance() const
 {
-  if ( !active || !valid[ CACHE_CORRUPTION_RESISTANCE ] )
+  if ( !check( CACHE_CORRUPTION_RESISTANCE ) )
   {
-    valid[ CACHE_CORRUPTION_RESISTANCE ] = true;
     _corruption_resistance               = player->composite_corruption_resistance();
   }
   else
@@ -544,9 +536,8 @@ double player_stat_cache_t::corruption_resistance() const
 
 double player_stat_cache_t::player_multiplier( school_e s ) const
 {
-  if ( !active || !player_mult_valid[ s ] )
+  if ( !check( CACHE_PLAYER_DAMAGE_MULTIPLIER, player_mult_computed[ s ] ) )
   {
-    player_mult_valid[ s ] = true;
     _player_mult[ s ]      = player->composite_player_multiplier( s );
   }
   else
@@ -558,9 +549,8 @@ double player_stat_cache_t::player_heal_multiplier( const action_state_t* s ) co
 {
   school_e sch = s->action->get_school();
 
-  if ( !active || !player_heal_mult_valid[ sch ] )
+  if ( !check( CACHE_PLAYER_HEAL_MULTIPLIER, player_heal_mult_computed[ sch ] ) )
   {
-    player_heal_mult_valid[ sch ] = true;
     _player_heal_mult[ sch ]      = player->composite_player_heal_multiplier( s );
   }
   else
@@ -8,6 +8,7 @@
 #include "config.hpp"
 #include "sc_enums.hpp"
 #include <array>
+#include <cstdint>
 
 
 struct action_state_t;
@@ -18,12 +19,11 @@ struct player_t;
  * often than it is changed, this reduces costly and unnecessary repetition of floating-point
  * operations.
  *
- * When a stat is accessed, its 'valid'-state is checked:
- *   If its true, the cached value is accessed.
- *   If it is false, the stat value is recalculated and written to the cache.
- *
- * To indicate when a stat gets modified, it needs to be 'invalidated'. Every time a stat
- * is invalidated, its 'valid'-state gets set to false.
+ * Validity is tracked with generation counters: every invalidation stamps the cache with a new
+ * generation, and every computed value remembers the generation it was computed at. When a stat
+ * is accessed, its value is valid if it was computed after the last invalidation of its cache (and
+ * after the last invalidate_all()); otherwise it is recalculated and written to the cache.
+ * Invalidating a stat therefore only writes a counter, and nothing needs to be cleared.
  */
 
 /* - To invalidate a stat, use player_t::invalidate_cache( cache_e )
@@ -31,18 +31,76 @@ struct player_t;
  * - Same goes for stat_buff_t, which works through player_t::stat_gain/loss
  * - Buffs with effects in a composite_ function need invalidates added to their buff_creator
  *
- * To create invalidation chains ( eg. Priest: Spirit invalidates Hit ) override the
- * virtual player_t::invalidate_cache( cache_e ) function.
+ * Invalidation chains between the generic stats ( eg. Strength invalidates Attack Power ) are
+ * declared in the stat cache dependency table in player.cpp. For class specific chains ( eg.
+ * Priest: Spirit invalidates Hit ) override the virtual player_t::invalidate_cache( cache_e ) function.
  *
- * Attention: player_t::invalidate_cache( cache_e ) is recursive and may call itself again.
+ * Attention: player_t::invalidate_cache( cache_e ) is recursive and may call itself again. Within
+ * one (recursive) invalidation pass each cache is invalidated at most once, no matter how many
+ * dependency paths lead to it.
  */
+
+#if defined( SC_STAT_CACHE_COUNTERS )
+// Per-cache access and invalidation counters, reported for cache tuning
+struct stat_cache_counters_t
+{
+  uint64_t hits          = 0;  // Accesses served from the cache
+  uint64_t misses        = 0;  // Accesses that recomputed a stale value
+  uint64_t invalidations = 0;  // Invalidations of the cache
+  uint64_t skipped       = 0;  // Invalidations skipped, already invalidated in the same pass
+
+  void merge( const stat_cache_counters_t& other )
+  {
+    hits += other.hits;
+    misses += other.misses;
+    invalidations += other.invalidations;
+    skipped += other.skipped;
+  }
+};
+#endif
+
 struct player_stat_cache_t
 {
   const player_t* player;
-  mutable std::array<bool, CACHE_MAX> valid;
-  mutable std::array<bool, SCHOOL_MAX + 1> spell_power_valid, player_mult_valid, player_heal_mult_valid;
-  mutable std::array<bool, static_cast<unsigned>( attack_power_type::NONE )> weapon_attack_power_valid;
-  // 'valid'-states
+private:
+  // Generation of the last invalidation, per cache and for invalidate_all()
+  uint64_t generation, all_invalidated;
+  std::array<uint64_t, CACHE_MAX> invalidated;
+  // Generation at the start of the current invalidation pass
+  uint64_t pass_generation;
+  unsigned pass_depth;
+  // Generations the cached values were computed at
+  mutable std::array<uint64_t, CACHE_MAX> computed;
+  mutable std::array<uint64_t, SCHOOL_MAX + 1> spell_power_computed, player_mult_computed, player_heal_mult_computed;
+  mutable std::array<uint64_t, static_cast<unsigned>( attack_power_type::NONE )> weapon_attack_power_computed;
+#if defined( SC_STAT_CACHE_COUNTERS )
+  mutable std::array<stat_cache_counters_t, CACHE_MAX> counters;
+#endif
+
+  bool check( cache_e c ) const
+  { return check( c, computed[ c ] ); }
+
+  // Returns true if a value computed at generation 'stamp' is still valid, otherwise restamps it
+  bool check( cache_e c, uint64_t& stamp ) const
+  {
+    if ( !active )
+      return false;
+
+    if ( stamp >= invalidated[ c ] && stamp >= all_invalidated )
+    {
+#if defined( SC_STAT_CACHE_COUNTERS )
+      ++counters[ c ].hits;
+#endif
+      return true;
+    }
+
+    stamp = generation;
+#if defined( SC_STAT_CACHE_COUNTERS )
+    ++counters[ c ].misses;
+#endif
+    return false;
+  }
+
 private:
   // cached values
   mutable double _strength, _agility, _stamina, _intellect, _spirit;
@@ -66,8 +124,18 @@ public:
   bool active; // runtime active-flag
   void invalidate_all();
   void invalidate( cache_e );
+  // Start invalidating a cache in the current invalidation pass. Returns false if the cache was
+  // already invalidated in this pass; otherwise invalidates it, and end_invalidation() must follow.
+  bool begin_invalidation( cache_e );
+  void end_invalidation()
+  { --pass_depth; }
+#if defined( SC_STAT_CACHE_COUNTERS )
+  const stat_cache_counters_t& get_counters( cache_e c ) const
+  { return counters[ c ]; }
+  void merge( const player_stat_cache_t& other );
+#endif
   double get_attribute( attribute_e ) const;
-  player_stat_cache_t( const player_t* p ) : player( p ), active( false ) { invalidate_all(); }
+  player_stat_cache_t( const player_t* p );
 #if defined(SC_USE_STAT_CACHE)
   // Cache stat functions
   double strength() const;
@@ -19,16 +19,37 @@ struct scaling_metric_data_t
   std::string name;
   double value, stddev;
   scale_metric_e metric;
+  const extended_sample_data_t* sample_data;  // Per iteration values of the metric, if any
   scaling_metric_data_t( scale_metric_e m, util::string_view n, double v, double dev )
-    : name( n ), value( v ), stddev( dev ), metric( m )
+    : name( n ), value( v ), stddev( dev ), metric( m ), sample_data( nullptr )
   {
   }
   scaling_metric_data_t( scale_metric_e m, const extended_sample_data_t& sd )
-    : name( sd.name_str ), value( sd.mean() ), stddev( sd.mean_std_dev ), metric( m )
+    : name( sd.name_str ), value( sd.mean() ), stddev( sd.mean_std_dev ), metric( m ), sample_data( &sd )
   {
   }
   scaling_metric_data_t( scale_metric_e m, const sc_timeline_t& tl, util::string_view name )
-    : name( name ), value( tl.mean() ), stddev( tl.mean_stddev() ), metric( m )
+    : name( name ), value( tl.mean() ), stddev( tl.mean_stddev() ), metric( m ), sample_data( nullptr )
   {
   }
-};
\ No newline at end of file
+};
+
+/* Standard deviation of the mean of a.value - b.value, estimated from the differences of the
+ * iterations of a and b, paired in order. With common random numbers the paired iterations ran
+ * with the same random numbers, and the difference has a much smaller error than the combined
+ * error of two independent means. Returns false if either metric has no iteration data, or the
+ * iteration counts differ.
+ */
+inline bool paired_mean_stddev( const scaling_metric_data_t& a, const scaling_metric_data_t& b, double& stddev )
+{
+  if ( !a.sample_data || !b.sample_data )
+    return false;
+
+  const auto& a_data = a.sample_data->data();
+  const auto& b_data = b.sample_data->data();
+  if ( a_data.size() < 2 || a_data.size() != b_data.size() )
+    return false;
+
+  stddev = statistics::calculate_paired_mean_stddev( a_data, b_data );
+  return true;
+}
\ No newline at end of file
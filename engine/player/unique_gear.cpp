@@ -4037,14 +4037,10 @@ void unique_gear::initialize_special_effect_2( special_effect_t* effect )
     // special effect registry, if they want.
     effect->player->init_special_effect( *effect );
 
-    if ( effect -> item )
-    {
-      new dbc_proc_callback_t( effect -> item, *effect );
-    }
-    else
-    {
-      new dbc_proc_callback_t( effect -> player, *effect );
-    }
+    // Generic callbacks use the base trigger(), so they can be excluded per action
+    auto cb = effect -> item ? new dbc_proc_callback_t( effect -> item, *effect )
+                             : new dbc_proc_callback_t( effect -> player, *effect );
+    cb -> prune_by_action = true;
   }
 }
 
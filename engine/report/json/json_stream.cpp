@@ -0,0 +1,211 @@
+// ==========================================================================
+// Dedmonwakeen's Raid DPS/TPS Simulator.
+// Send questions to natehieter@gmail.com
+// ==========================================================================
+
+#include "json_stream.hpp"
+
+#ifdef UNIT_TEST
+// Code to test that the streaming JSON report writes the same bytes as writing the report as one
+// DOM document
+
+#include "lib/fmt/format.h"
+#include "rapidjson/prettywriter.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+
+#include <limits>
+#include <string>
+
+using report::json::json_stream_t;
+using js::JsonOutput;
+
+namespace
+{
+int failures = 0;
+
+void check( bool ok, const std::string& what )
+{
+  if ( !ok )
+  {
+    fmt::print( "FAILED: {}\n", what );
+    ++failures;
+  }
+}
+
+// Parts of a small report, shaped like the sim, actor and profileset parts of the real report
+void header_to_json( JsonOutput root )
+{
+  root[ "version" ] = "1.0.0-test";
+  root[ "report_version" ] = "3.0.0";
+  root[ "ptr_enabled" ] = false;
+  root[ "timestamp" ] = uint64_t( 1700000000 );
+}
+
+void options_to_json( JsonOutput root )
+{
+  auto options_root = root[ "options" ];
+  options_root[ "max_time" ] = 300.0;
+  options_root[ "vary_combat_length" ] = 0.2;
+  options_root[ "iterations" ] = 10000;
+  options_root[ "target_error" ] = 1.0 / 3.0;
+  options_root[ "fight_style" ] = "Patchwerk";
+  options_root[ "dbc" ][ "ptr" ] = false;
+  options_root[ "dbc" ][ "build" ] = "10.2.0 \"quoted\"\n";
+}
+
+void player_to_json( JsonOutput& arr, int index )
+{
+  auto root = arr.add();
+  root[ "name" ] = fmt::format( "Actor_{}", index );
+  root[ "level" ] = 70;
+  root[ "collected_data" ][ "dps" ][ "mean" ] = 123456.789 * ( index + 1 );
+  root[ "collected_data" ][ "dps" ][ "min" ] = 100000.125;
+  root[ "collected_data" ][ "dps" ][ "max" ] = 1.5e7;
+  root[ "collected_data" ][ "timeline" ][ "data" ] = std::vector<double>{ 0.5, 1.25, 2.0 / 3.0 };
+  root[ "buffs" ].make_array();
+  if ( index > 0 )
+  {
+    auto buff = root[ "buffs" ].add();
+    buff[ "name" ] = "bloodlust";
+    buff[ "uptime" ] = 13.333;
+  }
+}
+
+void profileset_to_json( JsonOutput& results, int index )
+{
+  auto root = results.add();
+  root[ "name" ] = fmt::format( "profileset_{}", index );
+  root[ "mean" ] = 98765.4321 + index;
+  root[ "median" ] = 98000;
+}
+
+void footer_to_json( JsonOutput root, bool notifications )
+{
+  if ( notifications )
+  {
+    auto notes = root[ "notifications" ].make_array();
+    for ( util::string_view note : { "first", "second \\ with escapes \t" } )
+    {
+      rapidjson::Value v( note.data(), as<rapidjson::SizeType>( note.size() ), notes.doc().GetAllocator() );
+      notes.add( v );
+    }
+  }
+}
+
+constexpr int n_players = 3;
+constexpr int n_profilesets = 2;
+
+template <typename Writer>
+std::string write_dom( bool notifications, int decimal_places )
+{
+  rapidjson::Document doc;
+  doc.SetObject();
+  JsonOutput root( doc, doc );
+
+  header_to_json( root );
+  auto sim = root[ "sim" ];
+  options_to_json( sim );
+  auto players = sim[ "players" ].make_array();
+  for ( int i = 0; i < n_players; ++i )
+    player_to_json( players, i );
+  auto results = sim[ "profilesets" ][ "results" ].make_array();
+  for ( int i = 0; i < n_profilesets; ++i )
+    profileset_to_json( results, i );
+  footer_to_json( root, notifications );
+
+  rapidjson::StringBuffer b;
+  Writer writer( b );
+  if ( decimal_places > 0 )
+    writer.SetMaxDecimalPlaces( decimal_places );
+  doc.Accept( writer );
+  return b.GetString();
+}
+
+template <typename Writer>
+std::string write_stream( bool notifications, int decimal_places )
+{
+  rapidjson::StringBuffer b;
+  Writer writer( b );
+  if ( decimal_places > 0 )
+    writer.SetMaxDecimalPlaces( decimal_places );
+
+  json_stream_t<Writer> out( writer );
+  out.start_object();
+  out.members( []( JsonOutput root ) { header_to_json( root ); } );
+  out.key( "sim" );
+  out.start_object();
+  out.members( []( JsonOutput root ) { options_to_json( root ); } );
+  out.key( "players" );
+  out.start_array();
+  for ( int i = 0; i < n_players; ++i )
+    out.elements( [ i ]( JsonOutput& arr ) { player_to_json( arr, i ); } );
+  out.end_array();
+  out.key( "profilesets" );
+  out.start_object();
+  out.key( "results" );
+  out.start_array();
+  // All profileset results as one part, instead of a part per element
+  out.elements( []( JsonOutput& arr ) {
+    for ( int i = 0; i < n_profilesets; ++i )
+      profileset_to_json( arr, i );
+  } );
+  out.end_array();
+  out.end_object();
+  out.end_object();
+  out.members( [ notifications ]( JsonOutput root ) { footer_to_json( root, notifications ); } );
+  out.end_object();
+  return b.GetString();
+}
+
+template <typename Writer>
+void test_writer( const std::string& writer_name )
+{
+  for ( bool notifications : { false, true } )
+  {
+    for ( int decimal_places : { 0, 2 } )
+    {
+      auto dom = write_dom<Writer>( notifications, decimal_places );
+      auto stream = write_stream<Writer>( notifications, decimal_places );
+      check( !dom.empty() && dom == stream,
+             fmt::format( "{} notifications={} decimal_places={}: streamed report differs from the DOM report\n"
+                          "dom:\n{}\nstream:\n{}",
+                          writer_name, notifications, decimal_places, dom, stream ) );
+    }
+  }
+}
+
+// A part the writer does not accept stops the report, like a failed DOM document Accept() does
+void test_rejected_part()
+{
+  rapidjson::StringBuffer b;
+  rapidjson::Writer<rapidjson::StringBuffer> writer( b );
+  json_stream_t<rapidjson::Writer<rapidjson::StringBuffer>> out( writer );
+
+  bool thrown = false;
+  try
+  {
+    out.start_object();
+    out.members( []( JsonOutput root ) { root[ "value" ] = std::numeric_limits<double>::quiet_NaN(); } );
+  }
+  catch ( const std::runtime_error& )
+  {
+    thrown = true;
+  }
+
+  check( thrown, "non-finite value was accepted" );
+}
+}  // namespace
+
+int main()
+{
+  test_writer<rapidjson::Writer<rapidjson::StringBuffer>>( "Writer" );
+  test_writer<rapidjson::PrettyWriter<rapidjson::StringBuffer>>( "PrettyWriter" );
+  test_rejected_part();
+
+  fmt::print( "json_stream tests: {}\n", failures ? "FAILED" : "passed" );
+
+  return failures ? 1 : 0;
+}
+
+#endif  // UNIT_TEST
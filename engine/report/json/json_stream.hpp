@@ -0,0 +1,84 @@
+// ==========================================================================
+// Dedmonwakeen's Raid DPS/TPS Simulator.
+// Send questions to natehieter@gmail.com
+// ==========================================================================
+
+#pragma once
+
+#include "interfaces/sc_js.hpp"
+#include "rapidjson/document.h"
+#include "util/generic.hpp"
+#include "util/string_view.hpp"
+
+#include <stdexcept>
+
+namespace report::json
+{
+/**
+ * Streaming output of a JSON report through a RapidJSON SAX writer. Parts of the report are built as
+ * small DOM documents and written out as soon as they are complete, so the memory used by the report
+ * is bounded by its largest part (an actor), instead of the size of the whole report.
+ */
+template <typename Writer>
+class json_stream_t
+{
+  Writer& writer;
+
+  static void check( bool accepted )
+  {
+    if ( !accepted )
+    {
+      throw std::runtime_error( "JSON Writer did not accept document." );
+    }
+  }
+
+public:
+  json_stream_t( Writer& w ) : writer( w )
+  { }
+
+  void start_object()
+  { check( writer.StartObject() ); }
+
+  void end_object()
+  { check( writer.EndObject() ); }
+
+  void start_array()
+  { check( writer.StartArray() ); }
+
+  void end_array()
+  { check( writer.EndArray() ); }
+
+  void key( util::string_view name )
+  { check( writer.Key( name.data(), as<rapidjson::SizeType>( name.size() ) ) ); }
+
+  // Build members with fn, and write them to the currently open object
+  template <typename Fn>
+  void members( Fn&& fn )
+  {
+    rapidjson::Document doc;
+    doc.SetObject();
+    fn( js::JsonOutput( doc, doc ) );
+
+    for ( const auto& member : doc.GetObject() )
+    {
+      check( writer.Key( member.name.GetString(), member.name.GetStringLength() ) );
+      check( member.value.Accept( writer ) );
+    }
+  }
+
+  // Build array elements with fn, and write them to the currently open array
+  template <typename Fn>
+  void elements( Fn&& fn )
+  {
+    rapidjson::Document doc;
+    doc.SetArray();
+    js::JsonOutput arr( doc, doc );
+    fn( arr );
+
+    for ( const auto& value : doc.GetArray() )
+    {
+      check( value.Accept( writer ) );
+    }
+  }
+};
+}  // namespace report::json
@@ -10,6 +10,7 @@
 #include "rapidjson/prettywriter.h"
 #include "rapidjson/stringbuffer.h"
 #include "rapidjson/writer.h"
+#include "report/json/json_stream.hpp"
 #include "report/json/report_configuration.hpp"
 #include "report/report_timer.hpp"
 #include "report/reports.hpp"
@@ -237,6 +238,28 @@ void procs_to_json( JsonOutput root, const player_t& p )
   } );
 }
 
+#if defined( SC_STAT_CACHE_COUNTERS )
+void stat_cache_to_json( JsonOutput root, const player_t& p )
+{
+  root.make_array();
+  for ( cache_e c = CACHE_NONE; c < CACHE_MAX; ++c )
+  {
+    const auto& counters = p.cache.get_counters( c );
+    if ( counters.hits + counters.misses + counters.invalidations == 0 )
+    {
+      continue;
+    }
+
+    auto node = root.add();
+    node[ "name" ] = util::cache_type_string( c );
+    node[ "hits" ] = counters.hits;
+    node[ "misses" ] = counters.misses;
+    node[ "invalidations" ] = counters.invalidations;
+    node[ "skipped" ] = counters.skipped;
+  }
+}
+#endif
+
 bool has_valid_stats( const std::vector<stats_t*>& stats_list, int level = 0 )
 {
   return range::any_of( stats_list, [ level ]( const stats_t* stats ) {
@@ -474,7 +497,7 @@ void to_json( JsonOutput root, const player_t& p, const player_collected_data_t:
 }
 
 void to_json( JsonOutput root, const ::report::json::report_configuration_t& report_configuration,
-              const std::vector<player_collected_data_t::action_sequence_data_t>& asd,
+              const player_collected_data_t::action_sequence_t& asd,
               const std::vector<resource_e>& relevant_resources )
 {
   root.make_array();
@@ -488,7 +511,7 @@ void to_json( JsonOutput root, const ::report::json::report_configuration_t& rep
     {
       json[ "id" ] = entry.action->id;
       json[ "name" ] = entry.action->name();
-      json[ "target" ] = entry.action->harmful ? entry.target_name : "none";
+      json[ "target" ] = entry.action->harmful ? entry.target_name() : "none";
       json[ "spell_name" ] = entry.action->data_reporting().name_cstr();
       json[ "queue_failed" ] = entry.queue_failed;
       if ( entry.action->item )
@@ -501,11 +524,11 @@ void to_json( JsonOutput root, const ::report::json::report_configuration_t& rep
       json[ "wait" ] = entry.wait_time;
     }
 
-    if ( !entry.buff_list.empty() )
+    if ( !entry.buff_list().empty() )
     {
       auto buffs = json[ "buffs" ];
       buffs.make_array();
-      range::for_each( entry.buff_list, [ &buffs, &report_configuration ]( const auto& data ) {
+      range::for_each( entry.buff_list(), [ &buffs, &report_configuration ]( const auto& data ) {
         auto entry = buffs.add();
 
         entry[ "id" ] = data.object->data_reporting().id();
@@ -519,11 +542,11 @@ void to_json( JsonOutput root, const ::report::json::report_configuration_t& rep
     }
 
     // Writing cooldown and debuffs data if asking for json full states
-    if ( report_configuration.full_states && !entry.cooldown_list.empty() )
+    if ( report_configuration.full_states && !entry.cooldown_list().empty() )
     {
       auto cooldowns = json[ "cooldowns" ];
       cooldowns.make_array();
-      range::for_each( entry.cooldown_list, [ &cooldowns ]( const auto& data ) {
+      range::for_each( entry.cooldown_list(), [ &cooldowns ]( const auto& data ) {
         auto entry = cooldowns.add();
 
         entry[ "name" ] = data.object->name();
@@ -532,16 +555,16 @@ void to_json( JsonOutput root, const ::report::json::report_configuration_t& rep
       } );
     }
 
-    if ( report_configuration.full_states && !entry.target_list.empty() )
+    if ( report_configuration.full_states && !entry.target_list().empty() )
     {
       auto targets = json[ "targets" ];
       targets.make_array();
-      range::for_each( entry.target_list, [ &targets ]( const auto& target_data ) {
+      range::for_each( entry.target_list(), [ &targets, &entry ]( const auto& target_data ) {
         auto target_entry = targets.add();
-        target_entry[ "name" ] = target_data.first->name();
+        target_entry[ "name" ] = target_data.target->name();
         auto debuffs = target_entry[ "debuffs" ];
         debuffs.make_array();
-        range::for_each( target_data.second, [ &debuffs ]( const auto& data ) {
+        range::for_each( entry.debuff_list( target_data ), [ &debuffs ]( const auto& data ) {
           auto entry = debuffs.add();
           entry[ "name" ] = data.object->name();
           entry[ "stack" ] = data.value;
@@ -876,6 +899,13 @@ void to_json( JsonOutput& arr, const ::report::json::report_configuration_t& rep
       gains_to_json( root[ "gains" ], p );
     }
 
+#if defined( SC_STAT_CACHE_COUNTERS )
+    if ( p.cache.active )
+    {
+      stat_cache_to_json( root[ "stat_cache" ], p );
+    }
+#endif
+
     stats_to_json( root[ "stats" ], p.stats_list );
 
     // add pet stats as a separate property
@@ -991,136 +1021,138 @@ void profileset_fetch_output_data( const profileset::profile_output_data_t& outp
   }
 }
 
-void profileset_json2( const profileset::profilesets_t& profileset, const sim_t& sim, js::JsonOutput& root )
+// Add the result of a profileset to the results array of a report version 2 profileset object
+void profileset_result_json2( JsonOutput& results, profileset::profile_set_t& profileset, const sim_t& sim )
 {
-  root[ "metric" ] = util::scale_metric_type_string( sim.profileset_metric.front() );
-
-  auto results = root[ "results" ].make_array();
-
-  range::for_each( profileset.profilesets(),
-                   [ &results, &sim ]( const profileset::profilesets_t::profileset_entry_t& profileset ) {
-                     const auto& result = profileset->result();
-
-                     if ( result.mean() == 0 )
-                     {
-                       return;
-                     }
-
-                     auto&& obj = results.add();
-
-                     obj[ "name" ] = profileset->name();
-                     obj[ "mean" ] = result.mean();
-                     obj[ "min" ] = result.min();
-                     obj[ "max" ] = result.max();
-                     obj[ "stddev" ] = result.stddev();
-                     obj[ "mean_stddev" ] = result.mean_stddev();
-                     obj[ "mean_error" ] = result.mean_stddev() * sim.confidence_estimator;
-
-                     if ( result.median() != 0 )
-                     {
-                       obj[ "median" ] = result.median();
-                       obj[ "first_quartile" ] = result.first_quartile();
-                       obj[ "third_quartile" ] = result.third_quartile();
-                     }
-
-                     obj[ "iterations" ] = as<uint64_t>( result.iterations() );
-
-                     if ( profileset->results() > 1 )
-                     {
-                       auto results2 = obj[ "additional_metrics" ].make_array();
-                       for ( size_t midx = 1; midx < sim.profileset_metric.size(); ++midx )
-                       {
-                         auto obj2 = results2.add();
-                         const auto& result = profileset->result( sim.profileset_metric[ midx ] );
-
-                         obj2[ "metric" ] = util::scale_metric_type_string( sim.profileset_metric[ midx ] );
-                         obj2[ "mean" ] = result.mean();
-                         obj2[ "min" ] = result.min();
-                         obj2[ "max" ] = result.max();
-                         obj2[ "stddev" ] = result.stddev();
-                         obj2[ "mean_stddev" ] = result.mean_stddev();
-                         obj2[ "mean_error" ] = result.mean_stddev() * sim.confidence_estimator;
-
-                         if ( result.median() != 0 )
-                         {
-                           obj2[ "median" ] = result.median();
-                           obj2[ "first_quartile" ] = result.first_quartile();
-                           obj2[ "third_quartile" ] = result.third_quartile();
-                         }
-                       }
-                     }
-
-                     // Optional override ouput data
-                     if ( !sim.profileset_output_data.empty() )
-                     {
-                       const auto& output_data = profileset->output_data();
-                       // TODO: Create the overrides object only if there is at least one override registered
-                       auto ovr = obj[ "overrides" ];
-                       profileset_fetch_output_data( output_data, ovr );
-                     }
-                   } );
-}
+  const auto& result = profileset.result();
 
-void profileset_json3( const profileset::profilesets_t& profilesets, const sim_t& sim, js::JsonOutput& root )
-{
-  auto results = root[ "results" ].make_array();
-
-  range::for_each( profilesets.profilesets(),
-                   [ &results, &sim ]( const profileset::profilesets_t::profileset_entry_t& profileset ) {
-                     auto&& obj = results.add();
-                     obj[ "name" ] = profileset->name();
-                     auto results_obj = obj[ "metrics" ].make_array();
-
-                     for ( size_t midx = 0; midx < sim.profileset_metric.size(); ++midx )
-                     {
-                       const auto& result = profileset->result( sim.profileset_metric[ midx ] );
-
-                       auto&& obj = results_obj.add();
-
-                       obj[ "metric" ] = util::scale_metric_type_string( sim.profileset_metric[ midx ] );
-                       obj[ "mean" ] = result.mean();
-                       obj[ "min" ] = result.min();
-                       obj[ "max" ] = result.max();
-                       obj[ "stddev" ] = result.stddev();
-                       obj[ "mean_stddev" ] = result.mean_stddev();
-                       obj[ "mean_error" ] = result.mean_stddev() * sim.confidence_estimator;
-
-                       if ( result.median() != 0 )
-                       {
-                         obj[ "median" ] = result.median();
-                         obj[ "first_quartile" ] = result.first_quartile();
-                         obj[ "third_quartile" ] = result.third_quartile();
-                       }
-
-                       obj[ "iterations" ] = as<uint64_t>( result.iterations() );
-                     }
-
-                     // Optional override ouput data
-                     if ( !sim.profileset_output_data.empty() )
-                     {
-                       const auto& output_data = profileset->output_data();
-                       // TODO: Create the overrides object only if there is at least one override registered
-                       auto ovr = obj[ "overrides" ];
-                       profileset_fetch_output_data( output_data, ovr );
-                     }
-                   } );
+  if ( result.mean() == 0 )
+  {
+    return;
+  }
+
+  auto&& obj = results.add();
+
+  obj[ "name" ] = profileset.name();
+  obj[ "mean" ] = result.mean();
+  obj[ "min" ] = result.min();
+  obj[ "max" ] = result.max();
+  obj[ "stddev" ] = result.stddev();
+  obj[ "mean_stddev" ] = result.mean_stddev();
+  obj[ "mean_error" ] = result.mean_stddev() * sim.confidence_estimator;
+
+  if ( result.paired_mean_stddev() != 0 )
+  {
+    obj[ "paired_mean_stddev" ] = result.paired_mean_stddev();
+    obj[ "paired_mean_error" ] = result.paired_mean_stddev() * sim.confidence_estimator;
+  }
+
+  if ( result.median() != 0 )
+  {
+    obj[ "median" ] = result.median();
+    obj[ "first_quartile" ] = result.first_quartile();
+    obj[ "third_quartile" ] = result.third_quartile();
+  }
+
+  obj[ "iterations" ] = as<uint64_t>( result.iterations() );
+
+  if ( profileset.eliminated_at() > 0 )
+  {
+    obj[ "eliminated_at" ] = as<uint64_t>( profileset.eliminated_at() );
+  }
+
+  if ( profileset.results() > 1 )
+  {
+    auto results2 = obj[ "additional_metrics" ].make_array();
+    for ( size_t midx = 1; midx < sim.profileset_metric.size(); ++midx )
+    {
+      auto obj2 = results2.add();
+      const auto& result = profileset.result( sim.profileset_metric[ midx ] );
+
+      obj2[ "metric" ] = util::scale_metric_type_string( sim.profileset_metric[ midx ] );
+      obj2[ "mean" ] = result.mean();
+      obj2[ "min" ] = result.min();
+      obj2[ "max" ] = result.max();
+      obj2[ "stddev" ] = result.stddev();
+      obj2[ "mean_stddev" ] = result.mean_stddev();
+      obj2[ "mean_error" ] = result.mean_stddev() * sim.confidence_estimator;
+
+      if ( result.paired_mean_stddev() != 0 )
+      {
+        obj2[ "paired_mean_stddev" ] = result.paired_mean_stddev();
+        obj2[ "paired_mean_error" ] = result.paired_mean_stddev() * sim.confidence_estimator;
+      }
+
+      if ( result.median() != 0 )
+      {
+        obj2[ "median" ] = result.median();
+        obj2[ "first_quartile" ] = result.first_quartile();
+        obj2[ "third_quartile" ] = result.third_quartile();
+      }
+    }
+  }
+
+  // Optional override ouput data
+  if ( !sim.profileset_output_data.empty() )
+  {
+    const auto& output_data = profileset.output_data();
+    // TODO: Create the overrides object only if there is at least one override registered
+    auto ovr = obj[ "overrides" ];
+    profileset_fetch_output_data( output_data, ovr );
+  }
 }
-#endif
 
-void profileset_json( const ::report::json::report_configuration_t& report_configuration,
-                      const profileset::profilesets_t& profileset, const sim_t& sim, js::JsonOutput& root )
+// Add the result of a profileset to the results array of a report version 3 profileset object
+void profileset_result_json3( JsonOutput& results, profileset::profile_set_t& profileset, const sim_t& sim )
 {
-#ifndef SC_NO_THREADING
-  if ( report_configuration.version_intersects( ">=3.0.0" ) )
+  auto&& obj = results.add();
+  obj[ "name" ] = profileset.name();
+  if ( profileset.eliminated_at() > 0 )
   {
-    profileset_json3( profileset, sim, root );
+    obj[ "eliminated_at" ] = as<uint64_t>( profileset.eliminated_at() );
   }
-  else
+  auto results_obj = obj[ "metrics" ].make_array();
+
+  for ( size_t midx = 0; midx < sim.profileset_metric.size(); ++midx )
   {
-    profileset_json2( profileset, sim, root );
+    const auto& result = profileset.result( sim.profileset_metric[ midx ] );
+
+    auto&& obj = results_obj.add();
+
+    obj[ "metric" ] = util::scale_metric_type_string( sim.profileset_metric[ midx ] );
+    obj[ "mean" ] = result.mean();
+    obj[ "min" ] = result.min();
+    obj[ "max" ] = result.max();
+    obj[ "stddev" ] = result.stddev();
+    obj[ "mean_stddev" ] = result.mean_stddev();
+    obj[ "mean_error" ] = result.mean_stddev() * sim.confidence_estimator;
+
+    if ( result.paired_mean_stddev() != 0 )
+    {
+      obj[ "paired_mean_stddev" ] = result.paired_mean_stddev();
+      obj[ "paired_mean_error" ] = result.paired_mean_stddev() * sim.confidence_estimator;
+    }
+
+    if ( result.median() != 0 )
+    {
+      obj[ "median" ] = result.median();
+      obj[ "first_quartile" ] = result.first_quartile();
+      obj[ "third_quartile" ] = result.third_quartile();
+    }
+
+    obj[ "iterations" ] = as<uint64_t>( result.iterations() );
+  }
+
+  // Optional override ouput data
+  if ( !sim.profileset_output_data.empty() )
+  {
+    const auto& output_data = profileset.output_data();
+    // TODO: Create the overrides object only if there is at least one override registered
+    auto ovr = obj[ "overrides" ];
+    profileset_fetch_output_data( output_data, ovr );
   }
-#endif
 }
+#endif
 
 void dps_plot_json( const ::report::json::report_configuration_t& report_configuration, const plot_t& dps_plot,
                     const sim_t& sim, js::JsonOutput& root )
@@ -1183,259 +1215,290 @@ void reforge_plot_json( const ::report::json::report_configuration_t& report_con
   }
 }
 
-void to_json( const ::report::json::report_configuration_t& report_configuration, JsonOutput root, const sim_t& sim )
+using ::report::json::json_stream_t;
+
+template <typename Writer>
+void to_json( const ::report::json::report_configuration_t& report_configuration, json_stream_t<Writer>& out,
+              const sim_t& sim )
 {
-  // Sim-scope options
-  auto options_root = root[ "options" ];
-
-  options_root[ "debug" ] = sim.debug;
-  options_root[ "max_time" ] = sim.max_time.total_seconds();
-  options_root[ "expected_iteration_time" ] = sim.expected_iteration_time.total_seconds();
-  options_root[ "vary_combat_length" ] = sim.vary_combat_length;
-  options_root[ "iterations" ] = sim.iterations;
-  options_root[ "target_error" ] = sim.target_error;
-  options_root[ "threads" ] = sim.threads;
-  options_root[ "seed" ] = sim.seed;
-  options_root[ "single_actor_batch" ] = sim.single_actor_batch;
-  options_root[ "queue_lag" ] = sim.queue_lag;
-  options_root[ "queue_lag_stddev" ] = sim.queue_lag_stddev;
-  options_root[ "gcd_lag" ] = sim.gcd_lag;
-  options_root[ "gcd_lag_stddev" ] = sim.gcd_lag_stddev;
-  options_root[ "channel_lag" ] = sim.channel_lag;
-  options_root[ "channel_lag_stddev" ] = sim.channel_lag_stddev;
-  options_root[ "queue_gcd_reduction" ] = sim.queue_gcd_reduction;
-  options_root[ "strict_gcd_queue" ] = sim.strict_gcd_queue;
-  options_root[ "confidence" ] = sim.confidence;
-  options_root[ "confidence_estimator" ] = sim.confidence_estimator;
-  options_root[ "world_lag" ] = sim.world_lag;
-  options_root[ "world_lag_stddev" ] = sim.world_lag_stddev;
-  options_root[ "travel_variance" ] = sim.travel_variance;
-  options_root[ "default_skill" ] = sim.default_skill;
-  options_root[ "reaction_time" ] = sim.reaction_time;
-  options_root[ "regen_periodicity" ] = sim.regen_periodicity;
-  options_root[ "ignite_sampling_delta" ] = sim.ignite_sampling_delta;
-  options_root[ "fixed_time" ] = sim.fixed_time;
-  options_root[ "optimize_expressions" ] = sim.optimize_expressions;
-  options_root[ "optimal_raid" ] = sim.optimal_raid;
-  options_root[ "log" ] = sim.log;
-  options_root[ "debug_each" ] = sim.debug_each;
-  options_root[ "stat_cache" ] = sim.stat_cache;
-  options_root[ "max_aoe_enemies" ] = sim.max_aoe_enemies;
-  options_root[ "show_etmi" ] = sim.show_etmi;
-  options_root[ "tmi_window_global" ] = sim.tmi_window_global;
-  options_root[ "tmi_bin_size" ] = sim.tmi_bin_size;
-  options_root[ "enemy_death_pct" ] = sim.enemy_death_pct;
-  options_root[ "challenge_mode" ] = sim.challenge_mode;
-  options_root[ "timewalk" ] = sim.timewalk;
-  options_root[ "pvp_mode" ] = sim.pvp_mode;
-  options_root[ "rng" ] = sim.rng();
-  options_root[ "deterministic" ] = sim.deterministic;
-  options_root[ "average_range" ] = sim.average_range;
-  options_root[ "average_gauss" ] = sim.average_gauss;
-  options_root[ "fight_style" ] = util::fight_style_string( sim.fight_style );
-  options_root[ "desired_targets" ] = sim.desired_targets;
-  options_root[ "default_aura_delay" ] = sim.default_aura_delay;
-  options_root[ "default_aura_delay_stddev" ] = sim.default_aura_delay_stddev;
-  options_root[ "profileset_metric" ] = util::scale_metric_type_abbrev( sim.profileset_metric.front() );
-  options_root[ "profileset_multiactor_base_name" ] = sim.profileset_multiactor_base_name;
-
-  to_json( options_root[ "dbc" ], *sim.dbc );
-
-  if ( sim.scaling->calculate_scale_factors )
-  {
-    auto scaling_root = options_root[ "scaling" ];
-    scaling_root[ "calculate_scale_factors" ] = sim.scaling->calculate_scale_factors;
-    scaling_root[ "normalize_scale_factors" ] = sim.scaling->normalize_scale_factors;
-    add_non_zero( scaling_root, "scale_only", sim.scaling->scale_only_str );
-    add_non_zero( scaling_root, "scale_over", sim.scaling->scale_over );
-    add_non_zero( scaling_root, "scale_over_player", sim.scaling->scale_over_player );
-    add_non_default( scaling_root, "scale_delta_multiplier", sim.scaling->scale_delta_multiplier, 1.0 );
-    add_non_zero( scaling_root, "positive_scale_delta", sim.scaling->positive_scale_delta );
-    add_non_zero( scaling_root, "scale_lag", sim.scaling->scale_lag );
-    add_non_zero( scaling_root, "center_scale_delta", sim.scaling->center_scale_delta );
-  }
+  out.start_object();
+
+  out.members( [ & ]( JsonOutput root ) {
+    // Sim-scope options
+    auto options_root = root[ "options" ];
+
+    options_root[ "debug" ] = sim.debug;
+    options_root[ "max_time" ] = sim.max_time.total_seconds();
+    options_root[ "expected_iteration_time" ] = sim.expected_iteration_time.total_seconds();
+    options_root[ "vary_combat_length" ] = sim.vary_combat_length;
+    options_root[ "iterations" ] = sim.iterations;
+    options_root[ "target_error" ] = sim.target_error;
+    options_root[ "threads" ] = sim.threads;
+    options_root[ "seed" ] = sim.seed;
+    options_root[ "single_actor_batch" ] = sim.single_actor_batch;
+    options_root[ "queue_lag" ] = sim.queue_lag;
+    options_root[ "queue_lag_stddev" ] = sim.queue_lag_stddev;
+    options_root[ "gcd_lag" ] = sim.gcd_lag;
+    options_root[ "gcd_lag_stddev" ] = sim.gcd_lag_stddev;
+    options_root[ "channel_lag" ] = sim.channel_lag;
+    options_root[ "channel_lag_stddev" ] = sim.channel_lag_stddev;
+    options_root[ "queue_gcd_reduction" ] = sim.queue_gcd_reduction;
+    options_root[ "strict_gcd_queue" ] = sim.strict_gcd_queue;
+    options_root[ "confidence" ] = sim.confidence;
+    options_root[ "confidence_estimator" ] = sim.confidence_estimator;
+    options_root[ "world_lag" ] = sim.world_lag;
+    options_root[ "world_lag_stddev" ] = sim.world_lag_stddev;
+    options_root[ "travel_variance" ] = sim.travel_variance;
+    options_root[ "default_skill" ] = sim.default_skill;
+    options_root[ "reaction_time" ] = sim.reaction_time;
+    options_root[ "regen_periodicity" ] = sim.regen_periodicity;
+    options_root[ "ignite_sampling_delta" ] = sim.ignite_sampling_delta;
+    options_root[ "fixed_time" ] = sim.fixed_time;
+    options_root[ "optimize_expressions" ] = sim.optimize_expressions;
+    options_root[ "optimal_raid" ] = sim.optimal_raid;
+    options_root[ "log" ] = sim.log;
+    options_root[ "debug_each" ] = sim.debug_each;
+    options_root[ "stat_cache" ] = sim.stat_cache;
+    options_root[ "max_aoe_enemies" ] = sim.max_aoe_enemies;
+    options_root[ "show_etmi" ] = sim.show_etmi;
+    options_root[ "tmi_window_global" ] = sim.tmi_window_global;
+    options_root[ "tmi_bin_size" ] = sim.tmi_bin_size;
+    options_root[ "enemy_death_pct" ] = sim.enemy_death_pct;
+    options_root[ "challenge_mode" ] = sim.challenge_mode;
+    options_root[ "timewalk" ] = sim.timewalk;
+    options_root[ "pvp_mode" ] = sim.pvp_mode;
+    options_root[ "rng" ] = sim.rng();
+    options_root[ "deterministic" ] = sim.deterministic;
+    options_root[ "average_range" ] = sim.average_range;
+    options_root[ "average_gauss" ] = sim.average_gauss;
+    options_root[ "fight_style" ] = util::fight_style_string( sim.fight_style );
+    options_root[ "desired_targets" ] = sim.desired_targets;
+    options_root[ "default_aura_delay" ] = sim.default_aura_delay;
+    options_root[ "default_aura_delay_stddev" ] = sim.default_aura_delay_stddev;
+    options_root[ "profileset_metric" ] = util::scale_metric_type_abbrev( sim.profileset_metric.front() );
+    options_root[ "profileset_multiactor_base_name" ] = sim.profileset_multiactor_base_name;
+
+    to_json( options_root[ "dbc" ], *sim.dbc );
+
+    if ( sim.scaling->calculate_scale_factors )
+    {
+      auto scaling_root = options_root[ "scaling" ];
+      scaling_root[ "calculate_scale_factors" ] = sim.scaling->calculate_scale_factors;
+      scaling_root[ "normalize_scale_factors" ] = sim.scaling->normalize_scale_factors;
+      add_non_zero( scaling_root, "scale_only", sim.scaling->scale_only_str );
+      add_non_zero( scaling_root, "scale_over", sim.scaling->scale_over );
+      add_non_zero( scaling_root, "scale_over_player", sim.scaling->scale_over_player );
+      add_non_default( scaling_root, "scale_delta_multiplier", sim.scaling->scale_delta_multiplier, 1.0 );
+      add_non_zero( scaling_root, "positive_scale_delta", sim.scaling->positive_scale_delta );
+      add_non_zero( scaling_root, "scale_lag", sim.scaling->scale_lag );
+      add_non_zero( scaling_root, "center_scale_delta", sim.scaling->center_scale_delta );
+    }
 
-  // Overrides
-  auto overrides = root[ "overrides" ];
-  add_non_zero( overrides, "arcane_intellect", sim.overrides.arcane_intellect );
-  add_non_zero( overrides, "battle_shout", sim.overrides.battle_shout );
-  add_non_zero( overrides, "power_word_fortitude", sim.overrides.power_word_fortitude );
-  add_non_zero( overrides, "chaos_brand", sim.overrides.chaos_brand );
-  add_non_zero( overrides, "mystic_touch", sim.overrides.mystic_touch );
-  add_non_zero( overrides, "mortal_wounds", sim.overrides.mortal_wounds );
-  add_non_zero( overrides, "bleeding", sim.overrides.bleeding );
-  add_non_zero( overrides, "bloodlust", sim.overrides.bloodlust );
-  if ( sim.overrides.bloodlust )
-  {
-    add_non_zero( overrides, "bloodlust_percent", sim.bloodlust_percent );
-    add_non_zero( overrides, "bloodlust_time", sim.bloodlust_time );
-  }
+    // Overrides
+    auto overrides = root[ "overrides" ];
+    add_non_zero( overrides, "arcane_intellect", sim.overrides.arcane_intellect );
+    add_non_zero( overrides, "battle_shout", sim.overrides.battle_shout );
+    add_non_zero( overrides, "power_word_fortitude", sim.overrides.power_word_fortitude );
+    add_non_zero( overrides, "chaos_brand", sim.overrides.chaos_brand );
+    add_non_zero( overrides, "mystic_touch", sim.overrides.mystic_touch );
+    add_non_zero( overrides, "mortal_wounds", sim.overrides.mortal_wounds );
+    add_non_zero( overrides, "bleeding", sim.overrides.bleeding );
+    add_non_zero( overrides, "bloodlust", sim.overrides.bloodlust );
+    if ( sim.overrides.bloodlust )
+    {
+      add_non_zero( overrides, "bloodlust_percent", sim.bloodlust_percent );
+      add_non_zero( overrides, "bloodlust_time", sim.bloodlust_time );
+    }
 
-  if ( !sim.overrides.target_health.empty() )
-  {
-    overrides[ "target_health" ] = sim.overrides.target_health;
-  }
+    if ( !sim.overrides.target_health.empty() )
+    {
+      overrides[ "target_health" ] = sim.overrides.target_health;
+    }
+  } );
 
   // Players
-  JsonOutput players_arr = root[ "players" ].make_array();
-
+  out.key( "players" );
+  out.start_array();
   range::for_each( sim.player_no_pet_list.data(), [ & ]( const player_t* p ) {
-    to_json( players_arr, report_configuration, *p );
+    out.elements( [ & ]( JsonOutput& players_arr ) { to_json( players_arr, report_configuration, *p ); } );
   } );
+  out.end_array();
 
   if ( sim.profilesets->n_profilesets() > 0 )
   {
-    auto profileset_root = root[ "profilesets" ];
-    profileset_json( report_configuration, *sim.profilesets, sim, profileset_root );
-  }
+    out.key( "profilesets" );
+    out.start_object();
+#ifndef SC_NO_THREADING
+    bool json3 = report_configuration.version_intersects( ">=3.0.0" );
+    if ( !json3 )
+    {
+      out.members( [ & ]( JsonOutput root ) {
+        root[ "metric" ] = util::scale_metric_type_string( sim.profileset_metric.front() );
+      } );
+    }
 
-  if ( !sim.plot->dps_plot_stat_str.empty() )
-  {
-    auto dps_plot_root = root[ "dps_plot" ].make_array();
-    dps_plot_json( report_configuration, *sim.plot, sim, dps_plot_root );
+    out.key( "results" );
+    out.start_array();
+    range::for_each( sim.profilesets->profilesets(),
+                     [ & ]( const profileset::profilesets_t::profileset_entry_t& profileset ) {
+                       out.elements( [ & ]( JsonOutput& results ) {
+                         if ( json3 )
+                         {
+                           profileset_result_json3( results, *profileset, sim );
+                         }
+                         else
+                         {
+                           profileset_result_json2( results, *profileset, sim );
+                         }
+                       } );
+                     } );
+    out.end_array();
+#endif
+    out.end_object();
   }
 
-  if ( !sim.reforge_plot->reforge_plot_stat_str.empty() )
-  {
-    auto reforge_plot_root = root[ "reforge_plot" ].make_array();
-    reforge_plot_json( report_configuration, *sim.reforge_plot, sim, reforge_plot_root );
-  }
+  out.members( [ & ]( JsonOutput root ) {
+    if ( !sim.plot->dps_plot_stat_str.empty() )
+    {
+      auto dps_plot_root = root[ "dps_plot" ].make_array();
+      dps_plot_json( report_configuration, *sim.plot, sim, dps_plot_root );
+    }
 
-  auto stats_root = root[ "statistics" ];
-  stats_root[ "elapsed_cpu_seconds" ] = chrono::to_fp_seconds( sim.elapsed_cpu );
-  stats_root[ "elapsed_time_seconds" ] = chrono::to_fp_seconds( sim.elapsed_time );
-  stats_root[ "init_time_seconds" ] = chrono::to_fp_seconds( sim.init_time );
-  stats_root[ "merge_time_seconds" ] = chrono::to_fp_seconds( sim.merge_time );
-  stats_root[ "analyze_time_seconds" ] = chrono::to_fp_seconds( sim.analyze_time );
-  stats_root[ "simulation_length" ] = sim.simulation_length;
-  stats_root[ "total_events_processed" ] = sim.event_mgr.total_events_processed;
-  add_non_zero( stats_root, "raid_dps", sim.raid_dps );
-  add_non_zero( stats_root, "raid_hps", sim.raid_hps );
-  add_non_zero( stats_root, "raid_aps", sim.raid_aps );
-  add_non_zero( stats_root, "total_dmg", sim.total_dmg );
-  add_non_zero( stats_root, "total_heal", sim.total_heal );
-  add_non_zero( stats_root, "total_absorb", sim.total_absorb );
+    if ( !sim.reforge_plot->reforge_plot_stat_str.empty() )
+    {
+      auto reforge_plot_root = root[ "reforge_plot" ].make_array();
+      reforge_plot_json( report_configuration, *sim.reforge_plot, sim, reforge_plot_root );
+    }
+
+    auto stats_root = root[ "statistics" ];
+    stats_root[ "elapsed_cpu_seconds" ] = chrono::to_fp_seconds( sim.elapsed_cpu );
+    stats_root[ "elapsed_time_seconds" ] = chrono::to_fp_seconds( sim.elapsed_time );
+    stats_root[ "init_time_seconds" ] = chrono::to_fp_seconds( sim.init_time );
+    stats_root[ "merge_time_seconds" ] = chrono::to_fp_seconds( sim.merge_time );
+    stats_root[ "analyze_time_seconds" ] = chrono::to_fp_seconds( sim.analyze_time );
+    stats_root[ "simulation_length" ] = sim.simulation_length;
+    stats_root[ "total_events_processed" ] = sim.event_mgr.total_events_processed;
+    add_non_zero( stats_root, "raid_dps", sim.raid_dps );
+    add_non_zero( stats_root, "raid_hps", sim.raid_hps );
+    add_non_zero( stats_root, "raid_aps", sim.raid_aps );
+    add_non_zero( stats_root, "total_dmg", sim.total_dmg );
+    add_non_zero( stats_root, "total_heal", sim.total_heal );
+    add_non_zero( stats_root, "total_absorb", sim.total_absorb );
+  } );
 
   if ( sim.report_details != 0 )
   {
     // Targets
-    JsonOutput targets_arr = root[ "targets" ].make_array();
-
+    out.key( "targets" );
+    out.start_array();
     range::for_each( sim.target_list.data(), [ & ]( const player_t* p ) {
-      to_json( targets_arr, report_configuration, *p );
+      out.elements( [ & ]( JsonOutput& targets_arr ) { to_json( targets_arr, report_configuration, *p ); } );
     } );
+    out.end_array();
 
-    // Raid events
-    if ( !sim.raid_events.empty() )
-    {
-      auto arr = root[ "raid_events" ].make_array();
+    out.members( [ & ]( JsonOutput root ) {
+      // Raid events
+      if ( !sim.raid_events.empty() )
+      {
+        auto arr = root[ "raid_events" ].make_array();
 
-      range::for_each( sim.raid_events, [ & ]( const std::unique_ptr<raid_event_t>& event ) {
-        to_json( arr, *event );
-      } );
-    }
+        range::for_each( sim.raid_events, [ & ]( const std::unique_ptr<raid_event_t>& event ) {
+          to_json( arr, *event );
+        } );
+      }
 
-    if ( !sim.buff_list.empty() )
-    {
-      JsonOutput buffs_arr = root[ "sim_auras" ].make_array();
-      range::for_each( sim.buff_list, [ & ]( const buff_t* b ) {
-        if ( b->avg_start.mean() == 0 )
-        {
-          return;
-        }
-        to_json( buffs_arr.add(), b );
-      } );
-    }
+      if ( !sim.buff_list.empty() )
+      {
+        JsonOutput buffs_arr = root[ "sim_auras" ].make_array();
+        range::for_each( sim.buff_list, [ & ]( const buff_t* b ) {
+          if ( b->avg_start.mean() == 0 )
+          {
+            return;
+          }
+          to_json( buffs_arr.add(), b );
+        } );
+      }
 
-    if ( !sim.low_iteration_data.empty() )
-    {
-      iteration_data_to_json( root[ "iteration_data" ][ "low" ], sim.low_iteration_data );
-    }
+      if ( !sim.low_iteration_data.empty() )
+      {
+        iteration_data_to_json( root[ "iteration_data" ][ "low" ], sim.low_iteration_data );
+      }
 
-    if ( !sim.high_iteration_data.empty() )
-    {
-      iteration_data_to_json( root[ "iteration_data" ][ "high" ], sim.high_iteration_data );
-    }
+      if ( !sim.high_iteration_data.empty() )
+      {
+        iteration_data_to_json( root[ "iteration_data" ][ "high" ], sim.high_iteration_data );
+      }
+    } );
   }
-}
 
-void normal_print( FileWriteStream& stream, Document& doc,
-                   const ::report::json::report_configuration_t& report_configuration )
-{
-  Writer<FileWriteStream> writer( stream );
-  if ( report_configuration.decimal_places > 0 )
-  {
-    writer.SetMaxDecimalPlaces( report_configuration.decimal_places );
-  }
-  auto accepted = doc.Accept( writer );
-  if ( !accepted )
-  {
-    throw std::runtime_error( "JSON Writer did not accept document." );
-  }
+  out.end_object();
 }
 
-void pretty_print( FileWriteStream& stream, Document& doc,
-                   const ::report::json::report_configuration_t& report_configuration )
+template <typename Writer>
+void print_json_stream( Writer& writer, const sim_t& sim,
+                        const ::report::json::report_configuration_t& report_configuration )
 {
-  PrettyWriter<FileWriteStream> writer( stream );
   if ( report_configuration.decimal_places > 0 )
   {
     writer.SetMaxDecimalPlaces( report_configuration.decimal_places );
   }
-  auto accepted = doc.Accept( writer );
-  if ( !accepted )
-  {
-    throw std::runtime_error( "JSON Writer did not accept document." );
-  }
-}
 
-void print_json_pretty( FILE* o, const sim_t& sim, const ::report::json::report_configuration_t& report_configuration )
-{
-  Document doc;
-  Value& v = doc;
-  v.SetObject();
+  json_stream_t<Writer> out( writer );
 
-  JsonOutput root( doc, v );
+  out.start_object();
 
-  if ( report_configuration.version_intersects( ">=3.0.0" ) )
-  {
-    root[ "$id" ] =
-        fmt::format( "https://www.simulationcraft.org/reports/{}.schema.json", report_configuration.version() );
-  }
-  root[ "version" ] = SC_VERSION;
-  root[ "report_version" ] = report_configuration.version();
-  root[ "ptr_enabled" ] = SC_USE_PTR;
-  root[ "beta_enabled" ] = SC_BETA;
-  root[ "build_date" ] = __DATE__;
-  root[ "build_time" ] = __TIME__;
-  root[ "timestamp" ] = as<uint64_t>( std::time( nullptr ) );
-  if constexpr ( SC_NO_NETWORKING_ON )
-  {
-    root[ "no_networking" ] = true;
-  }
+  out.members( [ & ]( JsonOutput root ) {
+    if ( report_configuration.version_intersects( ">=3.0.0" ) )
+    {
+      root[ "$id" ] =
+          fmt::format( "https://www.simulationcraft.org/reports/{}.schema.json", report_configuration.version() );
+    }
+    root[ "version" ] = SC_VERSION;
+    root[ "report_version" ] = report_configuration.version();
+    root[ "ptr_enabled" ] = SC_USE_PTR;
+    root[ "beta_enabled" ] = SC_BETA;
+    root[ "build_date" ] = __DATE__;
+    root[ "build_time" ] = __TIME__;
+    root[ "timestamp" ] = as<uint64_t>( std::time( nullptr ) );
+    if constexpr ( SC_NO_NETWORKING_ON )
+    {
+      root[ "no_networking" ] = true;
+    }
 
-  if ( git_info::available() )
-  {
-    root[ "git_revision" ] = git_info::revision();
-    root[ "git_branch" ] = git_info::branch();
-  }
+    if ( git_info::available() )
+    {
+      root[ "git_revision" ] = git_info::revision();
+      root[ "git_branch" ] = git_info::branch();
+    }
+  } );
 
-  to_json( report_configuration, root[ "sim" ], sim );
+  out.key( "sim" );
+  to_json( report_configuration, out, sim );
 
-  if ( !sim.error_list.empty() )
-  {
-    root[ "notifications" ] = sim.error_list;
-  }
+  out.members( [ & ]( JsonOutput root ) {
+    AUTO_LOCK( sim.error_mutex );
+    if ( !sim.error_list.empty() )
+    {
+      root[ "notifications" ] = sim.error_list;
+    }
+  } );
 
+  out.end_object();
+}
+
+void print_json_pretty( FILE* o, const sim_t& sim, const ::report::json::report_configuration_t& report_configuration )
+{
   std::array<char, 16384> buffer;
   FileWriteStream b( o, buffer.data(), buffer.size() );
   if ( report_configuration.pretty_print )
   {
-    pretty_print( b, doc, report_configuration );
+    PrettyWriter<FileWriteStream> writer( b );
+    print_json_stream( writer, sim, report_configuration );
   }
   else
   {
-    normal_print( b, doc, report_configuration );
+    Writer<FileWriteStream> writer( b );
+    print_json_stream( writer, sim, report_configuration );
   }
 }
 
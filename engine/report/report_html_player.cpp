@@ -2405,7 +2405,7 @@ void print_html_sample_sequence_string_entry( report::sc_html_stream& os,
     }
   }
 
-  for ( const auto& b_data : data.buff_list )
+  for ( const auto& b_data : data.buff_list() )
   {
     buff_t* buff = b_data.object;
     int stacks   = b_data.value;
@@ -2451,7 +2451,7 @@ void print_html_sample_sequence_table_entry( report::sc_html_stream& os,
                data.action->action_list ? util::encode_html( data.action->action_list->name_str ).c_str() : "unknown",
                data.action->marker != 0 ? data.action->marker : ' ',
                util::encode_html( data.action->name() ).c_str(), data.queue_failed ? " (queue failed)" : "",
-               util::encode_html( data.target_name ).c_str() );
+               util::encode_html( data.target_name() ).c_str() );
   }
   else
   {
@@ -2499,7 +2499,7 @@ void print_html_sample_sequence_table_entry( report::sc_html_stream& os,
   os << "</td>\n"
      << "<td class=\"left\">";
   first = true;
-  for ( const auto& b_data : data.buff_list )
+  for ( const auto& b_data : data.buff_list() )
   {
     buff_t* buff = b_data.object;
     int stacks   = b_data.value;
@@ -4975,6 +4975,68 @@ void print_html_player_cooldown_waste( report::sc_html_stream& os, const player_
         "</div>\n";
 }
 
+#if defined( SC_STAT_CACHE_COUNTERS )
+// print_html_player_stat_cache =============================================
+
+void print_html_player_stat_cache( report::sc_html_stream& os, const player_t& p )
+{
+  if ( !p.sim->report_details || !p.cache.active || p.collected_data.fight_length.count() == 0 )
+    return;
+
+  auto used = []( const stat_cache_counters_t& c ) { return c.hits + c.misses + c.invalidations > 0; };
+  bool any_used = false;
+  for ( cache_e c = CACHE_NONE; c < CACHE_MAX; ++c )
+    any_used = any_used || used( p.cache.get_counters( c ) );
+
+  if ( !any_used )
+    return;
+
+  double iterations = as<double>( p.collected_data.fight_length.count() );
+
+  os << "<div class=\"player-section custom_section\">\n"
+        "<h3 class=\"toggle\">Stat Cache</h3>\n"
+        "<div class=\"toggle-content hide\">\n"
+        "<table class=\"sc sort even\">\n"
+        "<thead>\n"
+        "<tr>\n";
+
+  sorttable_header( os, "Cache", SORT_FLAG_ASC | SORT_FLAG_ALPHA | SORT_FLAG_LEFT );
+  sorttable_header( os, "Hits" );
+  sorttable_header( os, "Misses" );
+  sorttable_header( os, "Hit%" );
+  sorttable_header( os, "Invalidations" );
+  sorttable_header( os, "Skipped" );
+
+  os << "</tr>\n"
+        "</thead>\n";
+
+  for ( cache_e c = CACHE_NONE; c < CACHE_MAX; ++c )
+  {
+    const auto& counters = p.cache.get_counters( c );
+    if ( !used( counters ) )
+      continue;
+
+    auto accesses = counters.hits + counters.misses;
+
+    os << "<tr>";
+    fmt::print( os, "<td class=\"left\">{}</td>", c );
+    fmt::print( os, "<td class=\"right\">{:.1f}</td>", counters.hits / iterations );
+    fmt::print( os, "<td class=\"right\">{:.1f}</td>", counters.misses / iterations );
+    fmt::print( os, "<td class=\"right\">{:.2f}%</td>", accesses ? 100.0 * counters.hits / accesses : 0.0 );
+    fmt::print( os, "<td class=\"right\">{:.1f}</td>", counters.invalidations / iterations );
+    fmt::print( os, "<td class=\"right\">{:.1f}</td>", counters.skipped / iterations );
+    os << "</tr>\n";
+  }
+
+  os << "</table>\n"
+        "<div class=\"clear\"></div>\n"
+        "<p>Counts are per iteration. Misses recompute the stat, skipped invalidations were already "
+        "invalidated in the same invalidation pass.</p>\n"
+        "</div>\n"
+        "</div>\n";
+}
+#endif
+
 // print_html_player_deaths =================================================
 
 void print_html_player_deaths( report::sc_html_stream& os, const player_t& p,
@@ -5063,6 +5125,10 @@ void print_html_player_( report::sc_html_stream& os, const player_t& p )
 
   print_html_player_cooldown_waste( os, p );
 
+#if defined( SC_STAT_CACHE_COUNTERS )
+  print_html_player_stat_cache( os, p );
+#endif
+
   print_html_player_custom_section( os, p, p.report_information );
 
   print_html_player_resources( os, p );
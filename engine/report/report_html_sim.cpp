@@ -17,6 +17,7 @@
 #include "fmt/chrono.h"
 
 #include <iostream>
+#include <sstream>
 
 namespace
 {  // UNNAMED NAMESPACE ==========================================
@@ -1057,6 +1058,8 @@ void print_html_masthead( report::sc_html_stream& os, const sim_t& sim )
 
 void print_html_errors( report::sc_html_stream& os, const sim_t& sim )
 {
+  AUTO_LOCK( sim.error_mutex );
+
   if ( !sim.error_list.empty() )
   {
     os << "<pre class=\"section section-open\" style=\"color: black; background-color: white; font-weight: bold;\">\n";
@@ -1369,9 +1372,62 @@ void print_profilesets( std::ostream& out, const profileset::profilesets_t& prof
   out << "</div>";
 }
 
+/* Html report section of an actor, generated into a memory buffer along with its chart data
+ */
+struct html_player_section_t
+{
+  std::stringbuf buffer;
+  report::sc_html_stream os;
+  sim_t::chart_data_t charts;
+
+  html_player_section_t()
+  {
+    os.std::ios::rdbuf( &buffer );
+  }
+};
+
+/* Print the sections of the given actors, and their pets (when reported separately). Sections are
+ * independent of each other, so they are generated in parallel, and then written out in order.
+ */
+template <typename Filter>
+void print_html_players( report::sc_html_stream& os, sim_t& sim, const std::vector<player_t*>& players,
+                         Filter pet_filter )
+{
+  std::vector<player_t*> actors;
+  for ( auto& player : players )
+  {
+    actors.push_back( player );
+
+    if ( sim.report_pets_separately )
+    {
+      for ( auto& pet : player->pet_list )
+      {
+        if ( pet_filter( pet ) )
+          actors.push_back( pet );
+      }
+    }
+  }
+
+  std::vector<html_player_section_t> sections( actors.size() );
+
+  thread::parallel_for( actors.size(), as<unsigned>( std::max( 1, sim.threads ) ), [ & ]( size_t i ) {
+    auto& section = sections[ i ];
+    section.os.copyfmt( os );
+
+    sim_t::chart_capture_t capture( section.charts );
+    report::print_html_player( section.os, *actors[ i ] );
+  } );
+
+  for ( auto& section : sections )
+  {
+    os << section.buffer.str();
+    sim.add_chart_data( section.charts );
+  }
+}
+
 /* Main function building the html document and calling subfunctions
  */
-void print_html_( report::sc_html_stream& os, sim_t& sim )
+void print_html_( report::sc_html_stream& os, sim_t& sim, report_timer_t& timer )
 {
   // Set floating point formatting
   os.precision( sim.report_precision );
@@ -1422,21 +1478,12 @@ void print_html_( report::sc_html_stream& os, sim_t& sim )
 
   print_profilesets( os, *sim.profilesets, sim );
 
+  timer.stage( "raid summary" );
+
   // Report Players
-  for ( auto& player : sim.players_by_name )
-  {
-    report::print_html_player( os, *player );
+  print_html_players( os, sim, sim.players_by_name, []( const pet_t* pet ) { return pet->summoned && !pet->quiet; } );
 
-    // Pets
-    if ( sim.report_pets_separately )
-    {
-      for ( auto& pet : player->pet_list )
-      {
-        if ( pet->summoned && !pet->quiet )
-          report::print_html_player( os, *pet );
-      }
-    }
-  }
+  timer.stage( "players" );
 
   print_html_sim_summary( os, sim );
 
@@ -1446,22 +1493,11 @@ void print_html_( report::sc_html_stream& os, sim_t& sim )
   // Report Targets
   if ( sim.report_targets )
   {
-    for ( auto& player : sim.targets_by_name )
-    {
-      report::print_html_player( os, *player );
-
-      // Pets
-      if ( sim.report_pets_separately )
-      {
-        for ( auto& pet : player->pet_list )
-        {
-          // if ( pet -> summoned )
-          report::print_html_player( os, *pet );
-        }
-      }
-    }
+    print_html_players( os, sim, sim.targets_by_name, []( const pet_t* ) { return true; } );
   }
 
+  timer.stage( "sim summary and targets" );
+
   print_html_help_boxes( os, sim );
 
   // jQuery
@@ -1524,6 +1560,8 @@ void print_html_( report::sc_html_stream& os, sim_t& sim )
   os << "</script>\n"
      << "</body>\n\n"
      << "</html>\n";
+
+  timer.stage( "scripts and chart data" );
 }
 
 }  // UNNAMED NAMESPACE ====================================================
@@ -1551,7 +1589,7 @@ void print_html( sim_t& sim )
   }
 
   // Print html report
-  print_html_( s, sim );
+  print_html_( s, sim, t );
 }
 
 }  // report
@@ -752,10 +752,7 @@ void sim_summary_performance( std::ostream& os, sim_t* sim )
       "  TotalEvents   = {}\n"
       "  MaxEventQueue = {}\n"
 #ifdef EVENT_QUEUE_DEBUG
-      "  AllocEvents   = {}\n"
-      "  EndInsert     = {} ({:.3f}%)\n"
-      "  MaxTravDepth  = {}\n"
-      "  AvgTravDepth  = {}\n"
+      "  Cascades      = {} ({:.3f} per event)\n"
 #endif
       "  TargetHealth  = {:.0f}\n"
       "  SimSeconds    = {:.3f}\n"
@@ -773,11 +770,8 @@ void sim_summary_performance( std::ostream& os, sim_t* sim )
       sim->event_mgr.total_events_processed,
       sim->event_mgr.max_events_remaining,
 #ifdef EVENT_QUEUE_DEBUG
-      sim->event_mgr.n_allocated_events, sim->event_mgr.n_end_insert,
-      100.0 * static_cast<double>( sim->event_mgr.n_end_insert ) /
-          sim->event_mgr.events_added,
-      sim->event_mgr.max_queue_depth,
-      static_cast<double>( sim->event_mgr.events_traversed ) /
+      sim->event_mgr.events_cascaded,
+      static_cast<double>( sim->event_mgr.events_cascaded ) /
           sim->event_mgr.events_added,
 #endif
       sim->target->resources.base[ RESOURCE_HEALTH ],
@@ -791,27 +785,29 @@ void sim_summary_performance( std::ostream& os, sim_t* sim )
 #ifdef EVENT_QUEUE_DEBUG
   double total_p = 0;
 
-  for ( unsigned i = 0; i < sim->event_mgr.event_queue_depth_samples.size(); ++i )
+  uint64_t wheel_inserts = 0;
+  for ( auto count : sim->event_mgr.events_added_per_level )
+  {
+    wheel_inserts += count;
+  }
+
+  fmt::print( os, "Timing Wheel Inserts:\n" );
+  for ( unsigned i = 0; i < sim->event_mgr.events_added_per_level.size(); ++i )
   {
-    auto& sample = sim->event_mgr.event_queue_depth_samples[ i ];
-    if ( sample.first == 0 )
+    auto count = sim->event_mgr.events_added_per_level[ i ];
+    if ( count == 0 )
     {
       continue;
     }
 
-    double p = 100.0 * static_cast<double>( sample.first ) / sim->event_mgr.events_added;
-    double p2 = 100.0 * static_cast<double>( sample.second ) / sample.first;
+    double p = 100.0 * static_cast<double>( count ) / wheel_inserts;
     total_p += p;
-    fmt::print( os, "Depth: {:4} Samples: {:9} ({:6.3f}% / {:7.3f}%) tail-inserts: {:9} ({:7.3f}%)\n",
-        i,
-        sample.first, p, total_p,
-        sample.second, p2 );
-
-
+    fmt::print( os, "Level: {:2} Samples: {:9} ({:6.3f}% / {:7.3f}%)\n",
+        i, count, p, total_p );
   }
   fmt::print( os, "Total: {:.3f}% Samples: {}\n",
       total_p,
-      sim->event_mgr.events_added );
+      wheel_inserts );
 
   fmt::print( os, "\nEvent Queue Allocation:\n" );
   double total_a = 0;
@@ -836,8 +832,19 @@ void sim_summary_performance( std::ostream& os, sim_t* sim )
   fmt::print( os, "Total: {:.3f}% Alloc Samples: {}\n",
       total_p,
       sim->event_mgr.n_requested_events );
-  fmt::print( os, "Alloc size used for event_t: {}\n",
-      util::next_power_of_two( 2 * sizeof( event_t ) ) );
+
+  fmt::print( os, "\nEvent Slab Allocation:\n" );
+  for ( const auto& slab : sim->event_mgr.event_slabs )
+  {
+    if ( slab.n_requested == 0 )
+    {
+      continue;
+    }
+
+    fmt::print( os, "Size-Class: {:4} Requests: {:9} Carved: {:9} MaxPages: {:5} PagesAllocated: {:7} PagesReleased: {:7}\n",
+        slab.block_size, slab.n_requested, slab.n_carved, slab.max_pages,
+        slab.n_pages_allocated, slab.n_pages_released );
+  }
 #endif
 }
 
@@ -10,17 +10,20 @@
 
 #include <iosfwd>
 #include <string>
+#include <utility>
+#include <vector>
 
 /**
  * Automatic Timer reporting the time between construction and desctruction of
- * the object.
+ * the object, and optionally the time taken by each stage in between.
  */
 class report_timer_t
 {
 private:
   std::string title;
   std::FILE* out;
-  chrono::wall_clock::time_point start_time;
+  chrono::wall_clock::time_point start_time, stage_time;
+  std::vector<std::pair<std::string, double>> stages;
   bool started;
 
 public:
@@ -30,15 +33,33 @@ public:
 
   void start()
   {
-    start_time = chrono::wall_clock::now();
+    start_time = stage_time = chrono::wall_clock::now();
     started    = true;
   }
 
+  // End a stage, which took the time since the previous stage ended (or the timer started)
+  void stage( std::string name )
+  {
+    if ( started )
+    {
+      stages.emplace_back( std::move( name ), chrono::elapsed_fp_seconds( stage_time ) );
+      stage_time = chrono::wall_clock::now();
+    }
+  }
+
   ~report_timer_t()
   {
     if ( started )
     {
-      fmt::print( out, "{} took {}seconds.\n", title, chrono::elapsed_fp_seconds( start_time ) );
+      // Reports may be generated concurrently, print all lines at once
+      fmt::memory_buffer buffer;
+      fmt::format_to( std::back_inserter( buffer ), "{} took {}seconds.\n", title,
+                      chrono::elapsed_fp_seconds( start_time ) );
+      for ( const auto& stage : stages )
+      {
+        fmt::format_to( std::back_inserter( buffer ), "  {} took {}seconds.\n", stage.first, stage.second );
+      }
+      fmt::print( out, "{}", fmt::to_string( buffer ) );
     }
   }
-};
\ No newline at end of file
+};
@@ -8,14 +8,54 @@
 #include "dbc/dbc.hpp"
 #include "dbc/sc_spell_info.hpp"
 #include "dbc/spell_query/spell_data_expr.hpp"
+#include "player/pet.hpp"
 #include "player/player.hpp"
 #include "report/report_helper.hpp"
+#include "report/report_timer.hpp"
 #include "sim/sim.hpp"
+#include "util/concurrency.hpp"
 #include "util/xml.hpp"
 
 #include <ostream>
 #include <sstream>
 
+namespace
+{
+// Report data of the reported actors, shared by the text, json and html reports. Generated up front (in
+// parallel, it is independent per actor), so the reports do not modify the actors while generated
+// concurrently.
+void generate_report_data( sim_t* sim )
+{
+  std::vector<player_t*> actors;
+  auto add_actors = [ & ]( const std::vector<player_t*>& players ) {
+    for ( auto player : players )
+    {
+      actors.push_back( player );
+
+      if ( sim->report_pets_separately )
+      {
+        for ( auto pet : player->pet_list )
+        {
+          if ( pet->summoned && !pet->quiet )
+            actors.push_back( pet );
+        }
+      }
+    }
+  };
+
+  add_actors( sim->players_by_name );
+  if ( sim->report_targets )
+  {
+    add_actors( sim->targets_by_name );
+  }
+
+  thread::parallel_for( actors.size(), as<unsigned>( std::max( 1, sim->threads ) ), [ &actors ]( size_t i ) {
+    report_helper::generate_player_buff_lists( *actors[ i ], actors[ i ]->report_information );
+    report_helper::generate_player_charts( *actors[ i ], actors[ i ]->report_information );
+  } );
+}
+}  // namespace
+
 // report::print_profiles ===================================================
 namespace report
 {
@@ -238,9 +278,29 @@ void print_suite( sim_t* sim )
     fmt::print( "\nGenerating reports...\n" );
   }
 
+  report_timer_t t( "reports", stdout );
+  if ( !sim->profileset_enabled )
+  {
+    t.start();
+  }
+
+  generate_report_data( sim );
+  t.stage( "report data" );
+
+  // Text report goes to stdout by default, print it before the other reports print their timings
   report::print_text(sim, sim->report_details != 0);
-  report::print_json(*sim);
-  report::print_html(*sim);
+  t.stage( "text report" );
+
+  // JSON and html reports only read the sim and the report data, so they are generated concurrently
+  thread::parallel_for( 2, 2, [ sim ]( size_t i ) {
+    if ( i == 0 )
+      report::print_json( *sim );
+    else
+      report::print_html( *sim );
+  } );
+  t.stage( "json and html reports" );
+
   report::print_profiles(sim);
+  t.stage( "profiles" );
 }
 }  // namespace report
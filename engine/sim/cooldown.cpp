@@ -108,7 +108,8 @@ cooldown_t::cooldown_t( util::string_view n, player_t& p ) :
   execute_types_mask( 0U ),
   current_charge( 1 ),
   recharge_multiplier( 1.0 ),
-  base_duration( 0_ms )
+  base_duration( 0_ms ),
+  dirty( true )
 { }
 
 cooldown_t::cooldown_t( util::string_view n, sim_t& s ) :
@@ -129,7 +130,8 @@ cooldown_t::cooldown_t( util::string_view n, sim_t& s ) :
   execute_types_mask( 0U ),
   current_charge( 1 ),
   recharge_multiplier( 1.0 ),
-  base_duration( 0_ms )
+  base_duration( 0_ms ),
+  dirty( true )
 { }
 
 /**
@@ -145,6 +147,8 @@ void cooldown_t::adjust_recharge_multiplier()
     return;
   }
 
+  mark_dirty();
+
   double old_multiplier = recharge_multiplier;
   assert( action && "Only cooldowns with associated action can have their recharge multiplier adjusted." );
   recharge_multiplier = action->recharge_multiplier( *this ) * action->recharge_rate_multiplier( *this );
@@ -177,6 +181,8 @@ void cooldown_t::adjust_base_duration()
     return;
   }
 
+  mark_dirty();
+
   timespan_t old_duration = base_duration;
   assert( action && "Only cooldowns with associated action can have their base duration adjusted." );
   base_duration = action->cooldown_base_duration( *this );
@@ -201,6 +207,8 @@ void cooldown_t::adjust_remaining_duration( double delta )
   assert( ongoing() && delta > 0.0 );
   assert( charges > 0 && "Cooldown charges must be positive");
 
+  mark_dirty();
+
   timespan_t new_remains;
   timespan_t remains;
   if ( charges == 1 )
@@ -246,6 +254,8 @@ void cooldown_t::adjust( timespan_t amount, bool requires_reaction, bool apply_r
   if ( amount == 0_ms )
     return;
 
+  mark_dirty();
+
   if ( action && apply_recharge_rate )
     amount *= action->recharge_rate_multiplier( *this );
 
@@ -357,6 +367,24 @@ void cooldown_t::reset_init()
   ready_trigger_event = nullptr;
 }
 
+void cooldown_t::mark_dirty()
+{
+  if ( !dirty )
+  {
+    dirty = true;
+    player->dirty_cooldown_list.push_back( this );
+  }
+}
+
+bool cooldown_t::is_reset() const
+{
+  // Base duration is not compared, it is only used while the cooldown is ongoing, and start()
+  // always sets it
+  return ready == ( charges == 0 ? timespan_t::max() : ready_init() ) && last_start == 0_ms &&
+         last_charged == 0_ms && reset_react == 0_ms && current_charge == charges && recharge_multiplier == 1.0 &&
+         !recharge_event && !ready_trigger_event;
+}
+
 void cooldown_t::reset( bool require_reaction, int charges_ )
 {
   if ( charges_ == 0 )
@@ -364,6 +392,8 @@ void cooldown_t::reset( bool require_reaction, int charges_ )
   if ( charges_ < 0 )
     charges_ = charges;
 
+  mark_dirty();
+
   bool was_down = down();
   ready = ready_init();
 
@@ -423,6 +453,8 @@ void cooldown_t::start( action_t* a, timespan_t _override, timespan_t delay )
     return;
   }
 
+  mark_dirty();
+
   reset_react = 0_ms;
   action = a;
 
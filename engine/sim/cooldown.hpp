@@ -49,6 +49,10 @@ struct cooldown_t
   double recharge_multiplier;
   timespan_t base_duration;
 
+  // Set when the cooldown state changed since the last reset. Only cooldowns of the owner's cooldown
+  // list are recorded for reset (see player_t::reset), others stay dirty.
+  bool dirty;
+
   cooldown_t( util::string_view name, player_t& );
   cooldown_t( util::string_view name, sim_t& );
 
@@ -65,6 +69,12 @@ struct cooldown_t
 
   void reset_init();
 
+  // Record a state change, so the cooldown is reset at the end of the iteration
+  void mark_dirty();
+
+  // Return true if the cooldown is in the state reset_init() leaves it in
+  bool is_reset() const;
+
   timespan_t remains() const;
 
   timespan_t current_charge_remains() const;
@@ -39,7 +39,7 @@ constexpr unsigned next_power_of_two( unsigned v )
 // as such there are rules of use that must be honored:
 //
 // (1) The pure virtual execute() method MUST be implemented in the sub-class
-// (2) There is 1 * sizeof( event_t ) space available to extend the sub-class
+// (2) The sub-class may be at most event_t::MAX_ALLOC_SIZE bytes
 // (3) event_manager_t is responsible for deleting the memory associated with allocated events
 // (4) create events through make_event method
 struct event_t : private noncopyable
@@ -55,6 +55,12 @@ struct event_t : private noncopyable
 #ifdef ACTOR_EVENT_BOOKKEEPING
   actor_t*    actor;
 #endif
+
+  // Event memory is handed out by event_manager_t in power of two size classes, from
+  // MIN_ALLOC_SIZE up to MAX_ALLOC_SIZE bytes.
+  static constexpr unsigned MIN_ALLOC_SIZE = 64;
+  static constexpr unsigned MAX_ALLOC_SIZE = 512;
+
   event_t( sim_t& s, actor_t* a = nullptr );
   event_t( actor_t& a );
 
@@ -120,8 +126,7 @@ inline Event* make_event( sim_t& sim, Args&&... args )
 {
   static_assert( std::is_base_of<event_t, Event>::value,
                  "Event must be derived from event_t" );
-  static_assert( sizeof( Event ) <= util::next_power_of_two( 2 * sizeof( event_t ) ),
-                 "Event type is too big" );
+  static_assert( sizeof( Event ) <= event_t::MAX_ALLOC_SIZE, "Event type is too big" );
   auto r = new ( sim ) Event( std::forward<Args>(args)... );
   assert( r -> id != 0 && "Event not added to event manager!" );
   return r;
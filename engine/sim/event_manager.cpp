@@ -9,6 +9,24 @@
 #include "sim/sim.hpp"
 #include "player/player.hpp"
 
+namespace
+{
+unsigned highest_bit( uint64_t v )
+{
+  return timing_wheel_t<event_t, event_manager_t::event_time_t>::highest_bit( v );
+}
+}  // namespace
+
+inline uint64_t event_manager_t::event_time_t::get( const event_t* e )
+{
+  return static_cast<uint64_t>( e->time.total_millis() );
+}
+
+static_assert( event_manager_t::SLAB_HEADER_SIZE >= sizeof( event_manager_t::slab_page_header_t ),
+               "Slab page header does not fit" );
+static_assert( ( event_t::MIN_ALLOC_SIZE << ( event_manager_t::EVENT_SIZE_CLASSES - 1 ) ) == event_t::MAX_ALLOC_SIZE,
+               "Event size classes do not cover the maximum event size" );
+
 
 event_manager_t::event_manager_t( sim_t* s )
   : sim( s ),
@@ -16,85 +34,105 @@ event_manager_t::event_manager_t( sim_t* s )
     events_processed( 0 ),
     total_events_processed( 0 ),
     max_events_remaining( 0 ),
-    timing_slice( 0 ),
     global_event_id( 1 ),  // start at 1, so we can identify event -> id == 0
                            // meaning a unscheduled event.
     timing_wheel(),
-    recycled_event_list( nullptr ),
-    wheel_seconds( 0 ),
-    wheel_size( 0 ),
-    wheel_mask( 0 ),
-    wheel_shift( 5 ),
-    wheel_granularity( 0.0 ),
-    wheel_time( timespan_t::zero() ),
+    event_slabs(),
     event_stopwatch(),
-#ifdef EVENT_QUEUE_DEBUG
-    monitor_cpu( false ),
-    max_queue_depth( 0 ),
-    n_allocated_events( 0 ),
-    n_requested_events( 0 ),
-    n_end_insert( 0 ),
-    events_traversed( 0 ),
-    events_added( 0 )
-#else
     monitor_cpu( false ),
     canceled( false )
+#ifdef EVENT_QUEUE_DEBUG
+    ,
+    n_requested_events( 0 ),
+    events_cascaded( 0 ),
+    events_added( 0 ),
+    events_added_per_level()
 #endif /* EVENT_QUEUE_DEBUG */
 {
-  allocated_events.reserve( 100 );
+  for ( unsigned i = 0; i < event_slabs.size(); ++i )
+  {
+    event_slabs[ i ].block_size  = std::size_t( event_t::MIN_ALLOC_SIZE ) << i;
+    event_slabs[ i ].bump_offset = SLAB_HEADER_SIZE;
+  }
 }
 
 // event_manager_t::~event_manager_t ========================================
 
 event_manager_t::~event_manager_t()
 {
-  while ( recycled_event_list )
+  for ( auto& slab : event_slabs )
   {
-    event_t* e          = recycled_event_list;
-    recycled_event_list = e->next;
-    free( e );
+    for ( auto page : slab.pages )
+    {
+      ::operator delete( page, std::align_val_t( SLAB_PAGE_SIZE ) );
+    }
   }
 }
 
+// event_manager_t::slab_page_allocate ======================================
+
+void* event_manager_t::slab_page_allocate( unsigned size_class )
+{
+  // Pages are aligned to their size, so the owning slab of any block can be found from the
+  // header at the start of its page.
+  void* page = ::operator new( SLAB_PAGE_SIZE, std::align_val_t( SLAB_PAGE_SIZE ) );
+  new ( page ) slab_page_header_t{ size_class };
+
+  auto& slab = event_slabs[ size_class ];
+  slab.pages.push_back( page );
+#ifdef EVENT_QUEUE_DEBUG
+  slab.n_pages_allocated++;
+  slab.max_pages = std::max( slab.max_pages, static_cast<unsigned>( slab.pages.size() ) );
+#endif
+
+  return page;
+}
+
 // event_manager_t::allocate_event ==========================================
 
 void* event_manager_t::allocate_event( const std::size_t size )
 {
-  static constexpr std::size_t SIZE = util::next_power_of_two( 2 * sizeof( event_t ) );
-  assert( SIZE > size );
-  (void)size;
+  assert( size <= event_t::MAX_ALLOC_SIZE );
 
-  event_t* e = recycled_event_list;
+  const unsigned size_class = size <= event_t::MIN_ALLOC_SIZE
+                                  ? 0
+                                  : highest_bit( size - 1 ) + 1 - highest_bit( event_t::MIN_ALLOC_SIZE );
+  auto& slab = event_slabs[ size_class ];
 #ifdef EVENT_QUEUE_DEBUG
   n_requested_events++;
+  slab.n_requested++;
   if ( size >= event_requested_size_count.size() )
   {
     event_requested_size_count.resize( size + 1 );
   }
   event_requested_size_count[ size ]++;
 #endif
-  if ( e )
+
+  if ( event_t* e = slab.free_list )
   {
-    recycled_event_list = e->next;
+    slab.free_list = e->next;
+    return e;
   }
-  else
+
+  // Carve a fresh block, moving on to the next page when the current one is exhausted
+  if ( slab.bump_offset + slab.block_size > SLAB_PAGE_SIZE )
   {
-    e = (event_t*)malloc( SIZE );
+    slab.bump_page++;
+    slab.bump_offset = SLAB_HEADER_SIZE;
+  }
 
-    if ( !e )
-    {
-      throw std::bad_alloc();
-    }
-    else
-    {
+  if ( slab.bump_page == slab.pages.size() )
+  {
+    slab_page_allocate( size_class );
+  }
+
+  void* block = static_cast<char*>( slab.pages[ slab.bump_page ] ) + slab.bump_offset;
+  slab.bump_offset += slab.block_size;
 #ifdef EVENT_QUEUE_DEBUG
-      n_allocated_events++;
+  slab.n_carved++;
 #endif
-      allocated_events.push_back( e );
-    }
-  }
 
-  return e;
+  return block;
 }
 
 // event_manager_t::recycle_event ===========================================
@@ -102,9 +140,12 @@ void* event_manager_t::allocate_event( const std::size_t size )
 void event_manager_t::recycle_event( event_t* e )
 {
   e->~event_t();
-  e->recycled         = true;
-  e->next             = recycled_event_list;
-  recycled_event_list = e;
+  e->recycled = true;
+
+  auto page   = reinterpret_cast<uintptr_t>( e ) & ~uintptr_t( SLAB_PAGE_SIZE - 1 );
+  auto& slab  = event_slabs[ reinterpret_cast<const slab_page_header_t*>( page )->size_class ];
+  e->next        = slab.free_list;
+  slab.free_list = e;
 }
 
 // event_manager_t::add_event ===============================================
@@ -117,60 +158,18 @@ void event_manager_t::add_event( event_t* e, timespan_t delta_time )
   if ( delta_time < timespan_t::zero() )
     delta_time = timespan_t::zero();
 
-  if ( delta_time > wheel_time )
-  {
-    e->time = current_time + wheel_time - timespan_t::from_seconds( 1 );
-    e->reschedule_time = current_time + delta_time;
-  }
-  else
-  {
-    e->time            = current_time + delta_time;
-    e->reschedule_time = timespan_t::zero();
-  }
-
-  // Determine the timing wheel position to which the event will belong
-  // Only valid for integer based timespan_t
-  uint32_t slice = static_cast<uint32_t>(
-      ( e->time.total_millis() >> wheel_shift ) & wheel_mask );
+  if ( delta_time > timespan_t::max() - current_time )
+    delta_time = timespan_t::max() - current_time;
 
-  // Insert event into the event list at the appropriate time
-  event_t** prev = &( timing_wheel[ slice ] );
-#ifdef EVENT_QUEUE_DEBUG
-  unsigned traversed = 0;
-#endif
+  e->time            = current_time + delta_time;
+  e->reschedule_time = timespan_t::zero();
 
-  while ( ( *prev ) &&
-          ( *prev )->time <= e->time )  // Find position in the list
-  {
-    prev = &( ( *prev )->next );
-#ifdef EVENT_QUEUE_DEBUG
-    traversed++;
-#endif
-  }
 #ifdef EVENT_QUEUE_DEBUG
+  events_added_per_level[ timing_wheel.insert( e ) ]++;
   events_added++;
-  events_traversed += traversed;
-  if ( traversed > max_queue_depth )
-  {
-    max_queue_depth = traversed;
-  }
-  if ( traversed >= event_queue_depth_samples.size() )
-  {
-    event_queue_depth_samples.resize( traversed + 1 );
-  }
-  event_queue_depth_samples[ traversed ].first++;
-  if ( !(*prev) )
-  {
-    event_queue_depth_samples[ traversed ].second++;
-    if ( traversed )
-    {
-      n_end_insert++;
-    }
-  }
+#else
+  timing_wheel.insert( e );
 #endif
-  // insert event
-  e->next = *prev;
-  *prev   = e;
 
   if ( ++events_remaining > max_events_remaining )
     max_events_remaining = events_remaining;
@@ -280,6 +279,9 @@ bool event_manager_t::execute()
   }
 
   total_events_processed += events_processed;
+#ifdef EVENT_QUEUE_DEBUG
+  events_cascaded = timing_wheel.cascaded();
+#endif
 
   return true;
 }
@@ -302,48 +304,51 @@ void event_manager_t::cancel()
 
 void event_manager_t::flush()
 {
-  for ( auto e : allocated_events )
+  for ( auto& slab : event_slabs )
   {
-    if ( e->recycled )
-      continue;
-    event_t* null_e = e;  // necessary evil
-    event_t::cancel( null_e );
-    recycle_event( e );
+    // Every block below the bump pointer has been handed out at least once, and is either
+    // recycled or still holds a live event.
+    for ( std::size_t page = 0; page < slab.pages.size() && page <= slab.bump_page; ++page )
+    {
+      auto base = static_cast<char*>( slab.pages[ page ] );
+      std::size_t end = page == slab.bump_page ? slab.bump_offset : SLAB_PAGE_SIZE;
+      for ( std::size_t offset = SLAB_HEADER_SIZE; offset + slab.block_size <= end; offset += slab.block_size )
+      {
+        auto e = reinterpret_cast<event_t*>( base + offset );
+        if ( e->recycled )
+          continue;
+        event_t* null_e = e;  // necessary evil
+        event_t::cancel( null_e );
+        recycle_event( e );
+      }
+    }
+
+    // Release pages beyond the ones used this iteration, keeping one spare to avoid churn
+    std::size_t keep_pages = slab.pages.empty() ? 0 : std::min( slab.pages.size(), slab.bump_page + 2 );
+    while ( slab.pages.size() > keep_pages )
+    {
+      ::operator delete( slab.pages.back(), std::align_val_t( SLAB_PAGE_SIZE ) );
+      slab.pages.pop_back();
+#ifdef EVENT_QUEUE_DEBUG
+      slab.n_pages_released++;
+#endif
+    }
+
+    // All events are now free, so rewind the slab
+    slab.free_list   = nullptr;
+    slab.bump_page   = 0;
+    slab.bump_offset = SLAB_HEADER_SIZE;
   }
 
   // Clear Timing Wheel
-  timing_wheel.assign( timing_wheel.size(), nullptr );
+  timing_wheel.clear();
 }
 
 // event_manager_t::init ====================================================
 
 void event_manager_t::init()
 {
-  // Timing wheel depth defaults to about 17 minutes with a granularity of 32
-  // buckets per second.
-  // This makes wheel_size = 32K and it's fully used.
-  if ( wheel_seconds < 1024 )
-    wheel_seconds = 1024;  // 2^10 Min to ensure limited wrap-around
-  if ( wheel_granularity <= 0 )
-    wheel_granularity = 32;  // 2^5 Time slices per second
-
-  wheel_time = timespan_t::from_seconds( wheel_seconds );
-
-  // Only valid for integer based timespan_t
-  wheel_size = ( uint32_t )( wheel_time.total_millis() >> wheel_shift );
-
-  // Round up the wheel depth to the nearest power of 2 to enable a fast "mod"
-  // operation.
-  for ( wheel_mask = 2; wheel_mask < wheel_size; wheel_mask *= 2 )
-  {
-    continue;
-  }
-  wheel_size = wheel_mask;
-  wheel_mask--;
-
-  // The timing wheel represents an array of event lists: Each time slice has an
-  // event list.
-  timing_wheel.resize( wheel_size );
+  timing_wheel.clear();
 }
 
 // event_manager_t::next_event ==============================================
@@ -353,27 +358,17 @@ event_t* event_manager_t::next_event()
   if ( events_remaining == 0 )
     return nullptr;
 
-  while ( true )
+  event_t* e = timing_wheel.pop();
+  assert( e && "Timing wheel is empty with events remaining" );
+  if ( !e )
   {
-    event_t*& event_list = timing_wheel[ timing_slice ];
-    if ( event_list )
-    {
-      event_t* e = event_list;
-      event_list = e->next;
-      events_remaining--;
-      events_processed++;
-      return e;
-    }
-
-    timing_slice++;
-    if ( timing_slice == timing_wheel.size() )
-    {
-      timing_slice = 0;
-      // Time Wheel turns around.
-    }
+    events_remaining = 0;
+    return nullptr;
   }
 
-  return nullptr;
+  events_remaining--;
+  events_processed++;
+  return e;
 }
 
 // event_manager_t::reset ===================================================
@@ -382,10 +377,10 @@ void event_manager_t::reset()
 {
   events_remaining = 0;
   events_processed = 0;
-  timing_slice     = 0;
   global_event_id  = 0;
   canceled         = false;
   current_time     = timespan_t::zero();
+  timing_wheel.clear();
 }
 
 // event_manager_t::merge ===================================================
@@ -396,29 +391,29 @@ void event_manager_t::merge( event_manager_t& other )
       std::max( max_events_remaining, other.max_events_remaining );
   total_events_processed += other.total_events_processed;
 #ifdef EVENT_QUEUE_DEBUG
-  events_traversed += other.events_traversed;
+  events_cascaded += other.events_cascaded;
   events_added += other.events_added;
-  n_allocated_events += other.n_allocated_events;
-  n_end_insert += other.n_end_insert;
   n_requested_events += other.n_requested_events;
-  if ( other.max_queue_depth > max_queue_depth )
+  for ( size_t i = 0; i < event_slabs.size(); ++i )
   {
-    max_queue_depth = other.max_queue_depth;
+    auto& slab             = event_slabs[ i ];
+    const auto& other_slab = other.event_slabs[ i ];
+    slab.n_requested += other_slab.n_requested;
+    slab.n_carved += other_slab.n_carved;
+    slab.n_pages_allocated += other_slab.n_pages_allocated;
+    slab.n_pages_released += other_slab.n_pages_released;
+    slab.max_pages = std::max( slab.max_pages, other_slab.max_pages );
   }
-
-  if ( other.event_queue_depth_samples.size() >
-       event_queue_depth_samples.size() )
+  for ( size_t i = 0; i < events_added_per_level.size(); ++i )
   {
-    event_queue_depth_samples.resize( other.event_queue_depth_samples.size() );
+    events_added_per_level[ i ] += other.events_added_per_level[ i ];
   }
 
-  for ( size_t i = 0; i < other.event_queue_depth_samples.size(); ++i )
+  if ( other.event_requested_size_count.size() > event_requested_size_count.size() )
   {
-    event_queue_depth_samples[ i ].first +=
-        other.event_queue_depth_samples[ i ].first;
-    event_queue_depth_samples[ i ].second +=
-        other.event_queue_depth_samples[ i ].second;
+    event_requested_size_count.resize( other.event_requested_size_count.size() );
   }
+
   for ( size_t i = 0; i < other.event_requested_size_count.size(); ++i )
   {
     event_requested_size_count[ i ] += other.event_requested_size_count[ i ];
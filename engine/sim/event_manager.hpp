@@ -10,7 +10,9 @@
 #include "util/chrono.hpp"
 #include "util/stopwatch.hpp"
 #include "util/timespan.hpp"
+#include "util/timing_wheel.hpp"
 
+#include <array>
 #include <cstdint>
 #include <vector>
 
@@ -26,21 +28,51 @@ struct event_manager_t
   uint64_t events_processed;
   uint64_t total_events_processed;
   uint64_t max_events_remaining;
-  unsigned timing_slice, global_event_id;
-  std::vector<event_t*> timing_wheel;
-  event_t* recycled_event_list;
-  int wheel_seconds, wheel_size, wheel_mask, wheel_shift;
-  double wheel_granularity;
-  timespan_t wheel_time;
-  std::vector<event_t*> allocated_events;
+  unsigned global_event_id;
+
+  // Events are queued in a hierarchical timing wheel with millisecond ticks
+  struct event_time_t
+  {
+    static uint64_t get( const event_t* e );
+  };
+
+  timing_wheel_t<event_t, event_time_t> timing_wheel;
+
+  // Slab allocator for events. Each size class carves cache-line aligned blocks out of
+  // SLAB_PAGE_SIZE pages, handing out fresh blocks sequentially and reusing recycled ones through
+  // a free list. All events are released at the end of an iteration, so flush() rewinds the
+  // slabs and returns pages that the iteration did not need to the system.
+  static constexpr std::size_t SLAB_PAGE_SIZE   = 16384;
+  static constexpr std::size_t SLAB_HEADER_SIZE = 64;
+  static constexpr unsigned EVENT_SIZE_CLASSES  = 4;
+
+  struct slab_page_header_t
+  {
+    unsigned size_class;
+  };
+
+  struct event_slab_t
+  {
+    std::size_t block_size;
+    std::vector<void*> pages;
+    event_t* free_list;
+    std::size_t bump_page;
+    std::size_t bump_offset;
+#ifdef EVENT_QUEUE_DEBUG
+    uint64_t n_requested, n_carved;
+    unsigned n_pages_allocated, n_pages_released, max_pages;
+#endif
+  };
+
+  std::array<event_slab_t, EVENT_SIZE_CLASSES> event_slabs;
 
   stopwatch_t<chrono::thread_clock> event_stopwatch;
   bool monitor_cpu;
   bool canceled;
 #ifdef EVENT_QUEUE_DEBUG
-  unsigned max_queue_depth, n_allocated_events, n_end_insert, n_requested_events;
-  uint64_t events_traversed, events_added;
-  std::vector<std::pair<unsigned, unsigned> > event_queue_depth_samples;
+  unsigned n_requested_events;
+  uint64_t events_cascaded, events_added;
+  std::array<uint64_t, timing_wheel_t<event_t, event_time_t>::LEVELS> events_added_per_level;
   std::vector<unsigned> event_requested_size_count;
 #endif /* EVENT_QUEUE_DEBUG */
 
@@ -58,4 +90,7 @@ struct event_manager_t
   void reset();
   void merge( event_manager_t& other );
   void cancel_stuck( std::vector<std::string>& debug_list );
+
+private:
+  void* slab_page_allocate( unsigned size_class );
 };
@@ -0,0 +1,362 @@
+// ==========================================================================
+// Dedmonwakeen's Raid DPS/TPS Simulator.
+// Send questions to natehieter@gmail.com
+// ==========================================================================
+
+#include "iteration_data_file.hpp"
+
+#include "buff/buff.hpp"
+#include "player/pet.hpp"
+#include "player/player.hpp"
+#include "sim.hpp"
+#include "util/generic.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+template <typename T>
+void append( std::string& buffer, const T& value )
+{
+  buffer.append( reinterpret_cast<const char*>( &value ), sizeof( T ) );
+}
+
+template <typename T>
+void append( std::string& buffer, const std::vector<T>& values )
+{
+  buffer.append( reinterpret_cast<const char*>( values.data() ), values.size() * sizeof( T ) );
+}
+
+#ifndef UNIT_TEST
+// Amount per second of an actor and its pets, as collected in player_collected_data_t
+double per_second( const player_t* p, double player_t::*amount )
+{
+  double uptime = p->composite_active_time().total_seconds();
+  return uptime ? range::accumulate( p->pet_list, p->*amount, amount ) / uptime : 0;
+}
+#endif
+}  // namespace
+
+iteration_data_file_t::iteration_data_file_t( const std::string& file_name ) : has_header( false )
+{
+  out.open( file_name, io::ofstream::out | io::ofstream::trunc | io::ofstream::binary );
+}
+
+void iteration_data_file_t::write_header( const std::vector<column_t>& columns )
+{
+  std::lock_guard<std::mutex> lock( mutex );
+
+  if ( has_header )
+  {
+    // Blocks are decoded with the header schema, so a thread with other columns would corrupt the file
+    if ( columns.size() != header.size() )
+    {
+      throw std::runtime_error( fmt::format( "Iteration data file has {} columns, thread has {}.", header.size(),
+                                             columns.size() ) );
+    }
+
+    for ( size_t i = 0; i < columns.size(); ++i )
+    {
+      if ( columns[ i ].name != header[ i ].name || columns[ i ].type != header[ i ].type )
+      {
+        throw std::runtime_error( fmt::format( "Iteration data file column {} is '{}', thread has '{}'.", i,
+                                               header[ i ].name, columns[ i ].name ) );
+      }
+    }
+
+    return;
+  }
+
+  std::string encoded = "SCITDATA";
+  append( encoded, VERSION );
+  append( encoded, as<uint32_t>( columns.size() ) );
+  for ( const auto& column : columns )
+  {
+    append( encoded, column.type );
+    append( encoded, as<uint16_t>( column.name.size() ) );
+    encoded += column.name;
+  }
+
+  out.write( encoded.data(), as<std::streamsize>( encoded.size() ) );
+  header     = columns;
+  has_header = true;
+}
+
+void iteration_data_file_t::write_block( const std::string& block )
+{
+  std::lock_guard<std::mutex> lock( mutex );
+
+  out.write( block.data(), as<std::streamsize>( block.size() ) );
+  out.flush();
+}
+
+std::string iteration_data_file_t::encode_block( const std::vector<std::vector<uint64_t>>& uint64_columns,
+                                                 const std::vector<std::vector<double>>& double_columns )
+{
+  size_t rows = uint64_columns.empty() ? double_columns.front().size() : uint64_columns.front().size();
+
+  std::string block;
+  block.reserve( sizeof( uint32_t ) + rows * ( uint64_columns.size() + double_columns.size() ) * sizeof( double ) );
+
+  append( block, as<uint32_t>( rows ) );
+  for ( const auto& column : uint64_columns )
+  {
+    assert( column.size() == rows );
+    append( block, column );
+  }
+  for ( const auto& column : double_columns )
+  {
+    assert( column.size() == rows );
+    append( block, column );
+  }
+
+  return block;
+}
+
+#ifndef UNIT_TEST
+
+iteration_data_writer_t::iteration_data_writer_t( sim_t& s, iteration_data_file_t& f )
+  : sim( s ), file( f ), ids( 3 )
+{
+  columns.push_back( { "seed", iteration_data_file_t::COLUMN_UINT64 } );
+  columns.push_back( { "thread", iteration_data_file_t::COLUMN_UINT64 } );
+  columns.push_back( { "iteration", iteration_data_file_t::COLUMN_UINT64 } );
+
+  add_metric( "length", [ this ] { return sim.current_time().total_seconds(); } );
+  add_metric( "raid_dps", [ this ] {
+    return sim.current_time() > timespan_t::zero() ? sim.iteration_dmg / sim.current_time().total_seconds() : 0;
+  } );
+
+  auto buff_names = util::string_split<util::string_view>( sim.iteration_data_buffs, "/," );
+
+  for ( size_t i = 0; i < sim.player_no_pet_list.size(); ++i )
+  {
+    player_t* p = sim.player_no_pet_list[ i ];
+
+    // Actors that are not simulated in an iteration (single actor batch) report NaN
+    auto active = [ this, i ] {
+      return ! sim.single_actor_batch || sim.current_index == i;
+    };
+
+    auto metric = [ active ]( std::function<double()> fn ) {
+      return [ active, fn ] { return active() ? fn() : std::numeric_limits<double>::quiet_NaN(); };
+    };
+
+    add_metric( p->name_str + ".dps", metric( [ p ] { return per_second( p, &player_t::iteration_dmg ); } ) );
+    add_metric( p->name_str + ".hps", metric( [ p ] {
+      return per_second( p, &player_t::iteration_heal ) + per_second( p, &player_t::iteration_absorb );
+    } ) );
+    add_metric( p->name_str + ".dtps", metric( [ p ] {
+      double length = p->iteration_fight_length.total_seconds();
+      return length ? p->iteration_dmg_taken / length : 0;
+    } ) );
+
+    for ( auto buff_name : buff_names )
+    {
+      const buff_t* buff = buff_t::find( p, buff_name );
+      if ( ! buff )
+      {
+        continue;
+      }
+
+      add_metric( fmt::format( "{}.{}.uptime", p->name_str, buff->name_str ), metric( [ p, buff ] {
+        auto length = p->iteration_fight_length;
+        return length > timespan_t::zero() ? 100.0 * buff->iteration_uptime() / length : 0;
+      } ) );
+    }
+  }
+
+  file.write_header( columns );
+}
+
+void iteration_data_writer_t::add_metric( std::string name, std::function<double()> fn )
+{
+  columns.push_back( { std::move( name ), iteration_data_file_t::COLUMN_DOUBLE } );
+  metrics.push_back( std::move( fn ) );
+  values.emplace_back();
+}
+
+void iteration_data_writer_t::collect()
+{
+  ids[ 0 ].push_back( sim.iteration_seed );
+  ids[ 1 ].push_back( as<uint64_t>( sim.thread_index ) );
+  ids[ 2 ].push_back( as<uint64_t>( sim.global_iteration() ) );
+
+  for ( size_t i = 0; i < metrics.size(); ++i )
+  {
+    values[ i ].push_back( metrics[ i ]() );
+  }
+
+  if ( ids[ 0 ].size() >= BLOCK_SIZE )
+  {
+    flush();
+  }
+}
+
+void iteration_data_writer_t::flush()
+{
+  if ( ids[ 0 ].empty() )
+  {
+    return;
+  }
+
+  file.write_block( iteration_data_file_t::encode_block( ids, values ) );
+
+  for ( auto& column : ids )
+  {
+    column.clear();
+  }
+  for ( auto& column : values )
+  {
+    column.clear();
+  }
+}
+
+#endif  // UNIT_TEST
+
+#ifdef UNIT_TEST
+// Code to test the iteration data format, and that util_scripts/read_iteration_data.py reads it back
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+int failures = 0;
+
+void check( bool ok, const std::string& what )
+{
+  if ( !ok )
+  {
+    fmt::print( "FAILED: {}\n", what );
+    ++failures;
+  }
+}
+
+bool throws( iteration_data_file_t& file, const std::vector<iteration_data_file_t::column_t>& columns )
+{
+  try
+  {
+    file.write_header( columns );
+  }
+  catch ( const std::runtime_error& )
+  {
+    return true;
+  }
+  return false;
+}
+
+// Doubles written by Python's csv module ("nan", "inf", shortest round trip), compared bit exactly
+bool same_value( const std::string& text, double expected )
+{
+  double value = std::strtod( text.c_str(), nullptr );
+  return std::isnan( expected ) ? std::isnan( value ) : value == expected;
+}
+}  // namespace
+
+int main( int argc, char** argv )
+{
+  const std::string script = argc > 1 ? argv[ 1 ] : "../util_scripts/read_iteration_data.py";
+  const std::string file_name = "iteration_data_test.bin";
+  const std::string csv_name  = "iteration_data_test.csv";
+
+  using column_t = iteration_data_file_t::column_t;
+  const std::vector<column_t> columns = {
+    { "seed", iteration_data_file_t::COLUMN_UINT64 },
+    { "iteration", iteration_data_file_t::COLUMN_UINT64 },
+    { "raid_dps", iteration_data_file_t::COLUMN_DOUBLE },
+    { "Actor_With.Long-Name.dps", iteration_data_file_t::COLUMN_DOUBLE },
+  };
+
+  // Two blocks, like two threads flushing, with values that do not survive a round trip through
+  // float or a text format with fixed precision
+  std::vector<std::vector<std::vector<uint64_t>>> ids = {
+    { { 0, 1, ~uint64_t( 0 ) }, { 0, 1, 2 } },
+    { { ( uint64_t( 1 ) << 53 ) + 1 }, { 3 } },
+  };
+  std::vector<std::vector<std::vector<double>>> values = {
+    { { 0.1, -1e-300, 123456.789 }, { 1.0 / 3, std::numeric_limits<double>::quiet_NaN(), -0.0 } },
+    { { 1e300 }, { std::numeric_limits<double>::infinity() } },
+  };
+
+  {
+    iteration_data_file_t file( file_name );
+    check( file.is_open(), "open " + file_name );
+
+    file.write_header( columns );
+    file.write_header( columns );
+
+    auto renamed = columns;
+    renamed[ 2 ].name = "raid_hps";
+    check( throws( file, renamed ), "header with a different column name accepted" );
+
+    auto retyped = columns;
+    retyped[ 1 ].type = iteration_data_file_t::COLUMN_DOUBLE;
+    check( throws( file, retyped ), "header with a different column type accepted" );
+
+    auto extended = columns;
+    extended.push_back( { "extra", iteration_data_file_t::COLUMN_DOUBLE } );
+    check( throws( file, extended ), "header with an extra column accepted" );
+
+    for ( size_t i = 0; i < ids.size(); ++i )
+      file.write_block( iteration_data_file_t::encode_block( ids[ i ], values[ i ] ) );
+  }
+
+  int status = std::system( fmt::format( "python3 \"{}\" {} > {}", script, file_name, csv_name ).c_str() );
+  check( status == 0, fmt::format( "{} exited with status {}", script, status ) );
+
+  // The csv module ends lines with \r\n
+  std::ifstream csv( csv_name );
+  std::string line;
+  auto next_line = [ & ] {
+    if ( !std::getline( csv, line ) )
+      return false;
+    if ( !line.empty() && line.back() == '\r' )
+      line.pop_back();
+    return true;
+  };
+
+  next_line();
+  check( line == "seed,iteration,raid_dps,Actor_With.Long-Name.dps", "csv header: " + line );
+
+  size_t rows = 0;
+  for ( size_t block = 0; block < ids.size(); ++block )
+  {
+    for ( size_t row = 0; row < ids[ block ][ 0 ].size(); ++row, ++rows )
+    {
+      if ( !next_line() )
+      {
+        check( false, fmt::format( "csv ends after {} rows", rows ) );
+        break;
+      }
+
+      std::vector<std::string> fields;
+      std::istringstream fields_stream( line );
+      for ( std::string field; std::getline( fields_stream, field, ',' ); )
+        fields.push_back( field );
+
+      bool ok = fields.size() == columns.size();
+      for ( size_t c = 0; ok && c < ids[ block ].size(); ++c )
+        ok = fields[ c ] == fmt::format( "{}", ids[ block ][ c ][ row ] );
+      for ( size_t c = 0; ok && c < values[ block ].size(); ++c )
+        ok = same_value( fields[ ids[ block ].size() + c ], values[ block ][ c ][ row ] );
+      check( ok, fmt::format( "row {}: {}", rows, line ) );
+    }
+  }
+  check( !next_line(), "csv has extra rows: " + line );
+  csv.close();
+
+  std::remove( file_name.c_str() );
+  std::remove( csv_name.c_str() );
+
+  fmt::print( "Iteration data file tests: {}\n", failures ? "FAILED" : "passed" );
+
+  return failures ? 1 : 0;
+}
+
+#endif  // UNIT_TEST
@@ -0,0 +1,99 @@
+// ==========================================================================
+// Dedmonwakeen's Raid DPS/TPS Simulator.
+// Send questions to natehieter@gmail.com
+// ==========================================================================
+
+#pragma once
+
+#include "config.hpp"
+
+#include "util/io.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct sim_t;
+
+/* Binary columnar per-iteration output (iteration_data_file=<file>)
+ *
+ * The file starts with a schema header, followed by blocks of rows. All values are little endian.
+ *   header: magic "SCITDATA", uint32 version, uint32 column count, then per column a uint8 type
+ *           (0 = uint64, 1 = double), a uint16 name length and the name
+ *   block:  uint32 row count, then for each column (in header order) the values of all rows
+ *
+ * Each sim thread buffers its rows, and appends them to the file one block at a time, so rows of
+ * different threads interleave by block. The "thread" and "iteration" columns identify a row.
+ * util_scripts/read_iteration_data.py reads the format, the iteration_data_file unit test checks both.
+ */
+class iteration_data_file_t
+{
+public:
+  enum column_type_e : uint8_t
+  {
+    COLUMN_UINT64 = 0,
+    COLUMN_DOUBLE = 1
+  };
+
+  struct column_t
+  {
+    std::string   name;
+    column_type_e type;
+  };
+
+  static constexpr uint32_t VERSION = 1;
+
+  explicit iteration_data_file_t( const std::string& file_name );
+
+  bool is_open() const
+  { return out.is_open(); }
+
+  // Write the schema header, if not written yet. All threads must use the same schema, throws
+  // std::runtime_error if the columns differ from the written header.
+  void write_header( const std::vector<column_t>& columns );
+
+  // Append an encoded block of rows
+  void write_block( const std::string& block );
+
+  // Encode a block of rows from the values of each column, in header order. The uint64 columns must
+  // precede the double columns in the header.
+  static std::string encode_block( const std::vector<std::vector<uint64_t>>& uint64_columns,
+                                   const std::vector<std::vector<double>>& double_columns );
+
+private:
+  std::mutex            mutex;
+  io::ofstream          out;
+  bool                  has_header;
+  std::vector<column_t> header;
+};
+
+/* Per-sim (thread) row collection for iteration_data_file. Columns are bound to the actors and buffs
+ * of the owning sim when constructed, after the sim has been initialized.
+ */
+class iteration_data_writer_t
+{
+public:
+  // Rows buffered before appending a block to the file
+  static constexpr size_t BLOCK_SIZE = 1024;
+
+  iteration_data_writer_t( sim_t& sim, iteration_data_file_t& file );
+
+  // Add a row for the iteration that just finished
+  void collect();
+
+  // Append buffered rows to the file
+  void flush();
+
+private:
+  sim_t&                                       sim;
+  iteration_data_file_t&                       file;
+  std::vector<iteration_data_file_t::column_t> columns;
+  std::vector<std::function<double()>>         metrics;
+  // Buffered rows: seed, thread and iteration columns, followed by one column per metric
+  std::vector<std::vector<uint64_t>>           ids;
+  std::vector<std::vector<double>>             values;
+
+  void add_metric( std::string name, std::function<double()> fn );
+};
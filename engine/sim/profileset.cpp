@@ -7,14 +7,20 @@
 #include "dbc/dbc.hpp"
 #include "sim_control.hpp"
 #include "sim.hpp"
+#include "work_queue.hpp"
 #include "report/reports.hpp"
 #include "player/player.hpp"
 #include "player/player_talent_points.hpp"
+#include "player/scaling_metric_data.hpp"
 #include "item/item.hpp"
+#include "util/git_info.hpp"
+#include "util/io.hpp"
 #include "util/string_view.hpp"
 
 #ifndef SC_NO_THREADING
 
+#include <algorithm>
+#include <functional>
 #include <future>
 #include <iostream>
 #include <memory>
@@ -103,11 +109,15 @@ std::string format_time( double seconds, bool milliseconds = true )
 }
 
 // Deallocating profile_sim is the responsibility of the caller (i.e., profileset driver or
-// worker_t)
-void simulate_profileset( sim_t* parent, profileset::profile_set_t& set, sim_t*& profile_sim )
+// worker_t). A non-zero round_iterations runs a racing round with that many iterations (in total,
+// including the ones carried over from earlier rounds) instead of a full run.
+void simulate_profileset( sim_t* parent, profileset::profile_set_t& set, sim_t*& profile_sim, int round_iterations )
 {
-  // Reset random seed for the profileset sims
-  profile_sim -> seed = 0;
+  // Reset random seed for the profileset sims, unless they share random numbers with the baseline
+  if ( !parent -> common_random_numbers )
+  {
+    profile_sim -> seed = 0;
+  }
   profile_sim -> profileset_enabled = true;
   profile_sim -> report_details = 0;
   if ( parent -> profileset_work_threads > 0 )
@@ -123,12 +133,40 @@ void simulate_profileset( sim_t* parent, profileset::profile_set_t& set, sim_t*&
     profile_sim -> progress_bar.set_phase( set.name() );
   }
 
+  if ( round_iterations > 0 && ( profile_sim -> target_error > 0 || round_iterations < profile_sim -> iterations ) )
+  {
+    profile_sim -> iterations = round_iterations;
+    profile_sim -> target_error = 0;
+  }
+
+  // Continue from the iterations of earlier racing rounds instead of running them again, if the run
+  // has a fixed length. The new iterations follow the carried ones, so with common random numbers
+  // they still pair up with the baseline iterations of the same index.
+  int carried = set.racing_iterations();
+  if ( carried > 0 && ( profile_sim -> target_error > 0 || carried >= profile_sim -> iterations ||
+                        ( round_iterations == 0 && set.has_output() ) ) )
+  {
+    set.cleanup_racing_data();
+    carried = 0;
+  }
+
+  if ( carried > 0 )
+  {
+    profile_sim -> iterations -= carried;
+    profile_sim -> iteration_offset = carried;
+  }
+
+  if ( round_iterations > 0 || carried > 0 )
+  {
+    profile_sim -> work_queue -> init( profile_sim -> iterations );
+  }
+
   auto ret = profile_sim -> execute();
   if ( ret )
   {
     profile_sim -> progress_bar.restart();
 
-    if ( set.has_output() )
+    if ( set.has_output() && round_iterations == 0 )
     {
       report::print_suite( profile_sim );
     }
@@ -140,10 +178,35 @@ void simulate_profileset( sim_t* parent, profileset::profile_set_t& set, sim_t*&
   }
 
   const auto player = profile_sim -> player_no_pet_list[ parent->profileset_report_player_index ];
+  const auto parent_player = parent -> player_no_pet_list[ parent->profileset_report_player_index ];
   auto progress = profile_sim -> progress( nullptr, 0 );
 
-  range::for_each( parent -> profileset_metric, [ & ]( scale_metric_e metric ) {
-    auto data = profileset::metric_data( player, metric );
+  // Per iteration data of this run, appended to the carried data, for the next racing round
+  std::vector<std::vector<double>> racing_data;
+  bool keep_racing_data = round_iterations > 0;
+
+  for ( size_t i = 0; i < parent -> profileset_metric.size(); ++i )
+  {
+    auto metric = parent -> profileset_metric[ i ];
+    auto sample_data = profileset::metric_sample_data( player, metric );
+
+    // Sketched or combined metrics have no per iteration data to carry over
+    if ( ! sample_data || sample_data -> simple || sample_data -> sketched() )
+    {
+      keep_racing_data = false;
+    }
+
+    extended_sample_data_t combined( sample_data ? sample_data -> name_str : "", false );
+    if ( carried > 0 )
+    {
+      assert( sample_data && i < set.racing_data().size() );
+      range::for_each( set.racing_data()[ i ], [ &combined ]( double v ) { combined.add( v ); } );
+      range::for_each( sample_data -> data(), [ &combined ]( double v ) { combined.add( v ); } );
+      combined.analyze();
+      sample_data = &combined;
+    }
+
+    auto data = carried > 0 ? profileset::collect( combined ) : profileset::metric_data( player, metric );
 
     set.result( metric )
       .min( data.min )
@@ -154,12 +217,42 @@ void simulate_profileset( sim_t* parent, profileset::profile_set_t& set, sim_t*&
       .max( data.max )
       .stddev( data.std_dev )
       .mean_stddev( data.mean_std_dev )
-      .iterations( progress.current_iterations );
-  } );
+      .iterations( carried + progress.current_iterations );
+
+    if ( parent -> common_random_numbers )
+    {
+      auto paired_data = carried > 0 ? scaling_metric_data_t( metric, combined ) : player -> scaling_for_metric( metric );
+      auto baseline_data = parent_player -> scaling_for_metric( metric );
+      double paired_stddev = 0;
+      if ( paired_mean_stddev( paired_data, baseline_data, paired_stddev ) )
+      {
+        set.result( metric ).paired_mean_stddev( paired_stddev );
+      }
+      else if ( round_iterations == 0 )
+      {
+        parent -> profilesets -> unpaired_result( parent, set,
+            paired_data.sample_data ? paired_data.sample_data -> data().size() : 0,
+            baseline_data.sample_data ? baseline_data.sample_data -> data().size() : 0 );
+      }
+    }
+
+    if ( keep_racing_data )
+    {
+      racing_data.push_back( carried > 0 ? combined.data() : sample_data -> data() );
+    }
+  }
+
+  if ( keep_racing_data )
+  {
+    set.racing_data( carried + progress.current_iterations, std::move( racing_data ) );
+  }
+  else
+  {
+    set.cleanup_racing_data();
+  }
 
   if ( ! parent -> profileset_output_data.empty() )
   {
-    const auto parent_player = parent -> player_no_pet_list[ parent->profileset_report_player_index ];
     range::for_each( parent -> profileset_output_data, [ & ]( const std::string& option ) {
         save_output_data( set, parent_player, player, option );
     } );
@@ -172,7 +265,11 @@ void simulate_profileset( sim_t* parent, profileset::profile_set_t& set, sim_t*&
   parent -> analyze_time += profile_sim -> analyze_time;
   parent -> event_mgr.total_events_processed += profile_sim -> event_mgr.total_events_processed;
 
-  set.cleanup_options();
+  // Options are needed for the next racing round
+  if ( round_iterations == 0 )
+  {
+    set.cleanup_options();
+  }
 }
 
 // Figure out if the option defines new actor(s) with their own scope
@@ -189,6 +286,79 @@ bool is_actor_scope( const option_tuple_t& opt )
   } );
 }
 
+// Options that do not change simulation results, left out of result cache keys
+bool is_cache_neutral_option( util::string_view name )
+{
+  static constexpr util::string_view neutral_options[] = {
+    "threads", "process_priority", "profileset_work_threads", "profileset_init_threads", "profileset_cache",
+    "output", "html", "json", "json2", "report_details", "report_progress", "report_precision",
+  };
+
+  return range::contains( neutral_options, name );
+}
+
+// 64-bit FNV-1a of cache key fields, with a separator after each field
+void update_cache_hash( uint64_t& hash, util::string_view str )
+{
+  for ( unsigned char c : str )
+  {
+    hash = ( hash ^ c ) * 0x100000001b3ULL;
+  }
+  hash = ( hash ^ 0xff ) * 0x100000001b3ULL;
+}
+
+// Result cache key of a profileset, a hash of its (result-changing) sim options and the simulator
+// and client data versions
+std::string result_cache_key( const sim_control_t* control )
+{
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  auto update = [ &hash ]( util::string_view str ) { update_cache_hash( hash, str ); };
+
+  update( SC_VERSION );
+  update( git_info::available() ? git_info::revision() : "" );
+  update( dbc::client_data_version_str( false ) );
+  update( dbc::client_data_version_str( true ) );
+
+  for ( const auto& opt : control -> options )
+  {
+    if ( is_cache_neutral_option( opt.name ) )
+    {
+      continue;
+    }
+
+    update( opt.scope );
+    update( opt.name );
+    update( opt.value );
+  }
+
+  return fmt::format( "{:016x}", hash );
+}
+
+// With common random numbers, profileset results (including the paired error) are relative to the
+// random numbers and the results of the baseline run. Cached results are only valid for the same
+// seed and baseline, so the key is extended with a hash of both.
+std::string baseline_cache_key( const sim_t* parent )
+{
+  if ( ! parent -> common_random_numbers )
+  {
+    return {};
+  }
+
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  update_cache_hash( hash, fmt::format( "{}", parent -> seed ) );
+
+  const auto player = parent -> player_no_pet_list[ parent -> profileset_report_player_index ];
+  for ( auto metric : parent -> profileset_metric )
+  {
+    auto data = player -> scaling_for_metric( metric );
+    update_cache_hash( hash, fmt::format( "{} {} {:.17g} {:.17g}", util::scale_metric_type_abbrev( metric ),
+                                          data.sample_data ? data.sample_data -> count() : 0, data.value,
+                                          data.stddev ) );
+  }
+
+  return fmt::format( "-{:016x}", hash );
+}
+
 } // unnamed
 
 namespace profileset
@@ -294,9 +464,11 @@ profilesets_t::profilesets_t() : m_state( STARTED ), m_mode( SEQUENTIAL ),
     m_original( nullptr ), m_actor_indices(),
     m_work_index( 0 ),
     m_control_lock( m_mutex, std::defer_lock ),
-    m_max_workers( 0 ), 
+    m_max_workers( 0 ), m_busy( 0 ), m_shutdown( false ),
     m_work_lock( m_work_mutex, std::defer_lock ),
-    m_total_elapsed()
+    m_total_elapsed(),
+    m_round_iterations( 0 ), m_full_iterations( 0 ), m_full_target_error( 0 ),
+    m_unpaired_warned( false )
 { 
 
 }
@@ -310,11 +482,12 @@ profilesets_t::~profilesets_t()
     }
   } );
 
-  range::for_each( m_current_work, []( std::unique_ptr<worker_t>& worker ) { worker -> thread().join(); } );
+  stop_workers();
 }
 
 profile_set_t::profile_set_t( std::string name, sim_control_t* opts, bool has_output ) :
-  m_name( std::move(name) ), m_options( opts ), m_has_output( has_output ), m_output_data( nullptr )
+  m_name( std::move(name) ), m_options( opts ), m_has_output( has_output ), m_output_data( nullptr ),
+  m_eliminated_at( 0 ), m_racing_iterations( 0 )
 {
 }
 
@@ -378,89 +551,140 @@ profile_result_t& profile_set_t::result( scale_metric_e metric )
   return m_results.back();
 }
 
-worker_t::worker_t( profilesets_t* master, sim_t* p, profile_set_t* ps ) :
-  m_done( false ), m_parent( p ), m_master( master ), m_sim( nullptr ), m_profileset( ps ),
-  m_thread( nullptr )
+worker_t::worker_t( profilesets_t* master, sim_t* p ) :
+  m_parent( p ), m_master( master ), m_thread( [this] { execute(); } )
 {
-  m_thread = new std::thread( [this] { execute(); } );
 }
 
-worker_t::~worker_t()
+std::thread& worker_t::thread()
 {
-  delete m_sim;
-  delete m_thread;
+  return m_thread;
 }
 
-std::thread& worker_t::thread()
+const std::thread& worker_t::thread() const
 {
-  return *m_thread;
+  return m_thread;
 }
 
-const std::thread& worker_t::thread() const
+void worker_t::execute()
 {
-  return *m_thread;
+  while ( auto set = m_master -> next_work() )
+  {
+    sim_t* sim = nullptr;
+    bool failed = false;
+
+    try
+    {
+      // A new sim per profileset, the setup cost is not saved by the worker pool
+      sim = new sim_t( m_parent, 0, set -> options() );
+
+      simulate_profileset( m_parent, *set, sim, m_master -> round_iterations() );
+
+      m_master -> cache_result( m_parent, *set );
+    }
+    catch (const std::exception& e )
+    {
+      failed = true;
+      fmt::print( stderr, "\n\nError in profileset worker: " );
+      util::print_chained_exception( e, stderr );
+      fmt::print( stderr, "\n\n" );
+      std::fflush( stderr );
+    }
+
+    // A failed profileset fails the run, like it does in sequential mode. Canceling marks the
+    // profilesets done before this work is finished, so the driver stops queueing and racing once
+    // it wakes up, and the other workers exit on their next request for work. Nothing the cancel
+    // waits for (the profileset init threads) waits on the workers.
+    if ( failed )
+    {
+      m_parent -> cancel();
+    }
+
+    m_master -> finish_work( sim );
+
+    delete sim;
+  }
 }
 
-sim_t* worker_t::sim() const
+int profilesets_t::round_iterations() const
 {
-  return m_sim;
+  return m_round_iterations;
 }
 
-void worker_t::execute()
+// Count the number of queued and running profilesets. Note, we must own the work mutex here.
+size_t profilesets_t::n_workers() const
 {
-  try
-  {
-    m_sim = new sim_t( m_parent, 0, m_profileset -> options() );
+  return m_queue.size() + m_busy;
+}
 
-    simulate_profileset( m_parent, *m_profileset, m_sim );
-  }
-  catch (const std::exception& e )
+// Spawn the parallel profileset workers. They stay alive (and wait for more work) until
+// stop_workers() is called, so racing rounds reuse the same worker threads.
+void profilesets_t::start_workers( sim_t* parent )
+{
+  m_shutdown = false;
+
+  for ( size_t i = 0; i < m_max_workers; ++i )
   {
-    fmt::print( stderr, "\n\nError in profileset worker: " );
-    util::print_chained_exception( e, stderr );
-    fmt::print( stderr, "\n\n" );
-    std::fflush( stderr );
-    // TODO: find out how to cancel profilesets without deadlock.
+    m_workers.push_back( std::make_unique<worker_t>( this, parent ) );
   }
-
-  m_done = true;
-
-  m_master -> notify_worker();
 }
 
-// Count the number of running workers
-size_t profilesets_t::n_workers() const
+void profilesets_t::stop_workers()
 {
-  return range::count_if( m_current_work, []( const std::unique_ptr<worker_t>& worker ) {
-    return ! worker -> is_done();
+  {
+    std::lock_guard<std::mutex> lock( m_work_mutex );
+    m_shutdown = true;
+  }
+
+  m_work.notify_all();
+
+  range::for_each( m_workers, []( std::unique_ptr<worker_t>& worker ) {
+    if ( worker -> thread().joinable() )
+    {
+      worker -> thread().join();
+    }
   } );
+
+  m_workers.clear();
 }
 
-// Note, we must own the work mutex here.
-void profilesets_t::cleanup_work()
+profile_set_t* profilesets_t::next_work()
 {
-  assert( m_work_lock.owns_lock() );
+  std::unique_lock<std::mutex> lock( m_work_mutex );
 
-  auto it = m_current_work.begin();
+  m_work.wait( lock, [ this ] { return m_shutdown || ! m_queue.empty(); } );
 
-  while ( it != m_current_work.end() )
+  // Canceled profilesets drop any queued work
+  if ( m_shutdown || is_done() )
   {
-    if ( ( *it ) -> is_done() )
-    {
-      ( *it ) -> thread().join();
+    m_queue.clear();
+    lock.unlock();
+    m_work.notify_all();
+    return nullptr;
+  }
 
-      auto sim = ( *it ) -> sim();
+  auto set = m_queue.front();
+  m_queue.pop_front();
+  ++m_busy;
 
-      // Pure iterative time
-      m_total_elapsed += sim -> elapsed_time;
+  return set;
+}
 
-      it = m_current_work.erase( it );
-    }
-    else
+void profilesets_t::finish_work( const sim_t* sim )
+{
+  {
+    std::lock_guard<std::mutex> lock( m_work_mutex );
+
+    // Pure iterative time
+    if ( sim )
     {
-      ++it;
+      m_total_elapsed += sim -> elapsed_time;
     }
+
+    --m_busy;
   }
+
+  m_work.notify_all();
 }
 
 // Wait until we have all the work done
@@ -472,39 +696,39 @@ void profilesets_t::finalize_work()
     return;
   }
 
-  while ( !m_current_work.empty() )
-  {
-    assert( ! m_work_lock.owns_lock() );
-
-    m_work_lock.lock();
+  assert( ! m_work_lock.owns_lock() );
 
-    // If we still have active workers around, wait for them to signal their finish
-    // TODO: Potential race? (wait vs notify_worker() called from thread)
-    if ( n_workers() > 0 )
-    {
-      m_work.wait( m_work_lock );
-    }
+  m_work_lock.lock();
 
-    // Aand clean up finished sims
-    cleanup_work();
-
-    m_work_lock.unlock();
+  // Wait for queued and running profilesets to finish
+  while ( n_workers() > 0 )
+  {
+    m_work.wait( m_work_lock );
   }
+
+  m_work_lock.unlock();
 }
 
-void profilesets_t::generate_work( sim_t* parent, std::unique_ptr<profile_set_t>& ptr_set )
+void profilesets_t::generate_work( sim_t* parent, profile_set_t& set )
 {
+  if ( m_round_iterations == 0 && load_cached_result( parent, set ) )
+  {
+    return;
+  }
+
   if ( m_mode == SEQUENTIAL )
   {
     auto original_opts = parent -> control;
 
-    parent -> control = ptr_set -> options();
+    parent -> control = set.options();
 
     sim_t* profile_sim = new sim_t( parent );
 
     parent -> control = original_opts;
 
-    simulate_profileset( parent, *ptr_set, profile_sim );
+    simulate_profileset( parent, set, profile_sim, m_round_iterations );
+
+    cache_result( parent, set );
 
     delete profile_sim;
   }
@@ -513,22 +737,23 @@ void profilesets_t::generate_work( sim_t* parent, std::unique_ptr<profile_set_t>
   {
     m_work_lock.lock();
 
-    while ( ! is_done() && m_max_workers - n_workers() == 0 )
+    // Queue at most one profileset per worker, so the work index follows simulated profilesets
+    while ( ! is_done() && n_workers() >= m_max_workers )
     {
       m_work.wait( m_work_lock );
     }
 
     if ( ! is_done() )
     {
-      cleanup_work();
-
       // Output profileset progressbar whenever we finish anything
       output_progressbar( parent );
 
-      m_current_work.push_back( std::make_unique<worker_t>( this, parent, ptr_set.get() ) );
+      m_queue.push_back( &set );
     }
 
     m_work_lock.unlock();
+
+    m_work.notify_all();
   }
 }
 
@@ -590,6 +815,10 @@ bool profilesets_t::parse( sim_t* sim )
 
       test_sim -> setup( control );
       test_sim -> init();
+
+      std::lock_guard<std::mutex> lock( m_mutex );
+      m_full_iterations = std::max( m_full_iterations, test_sim -> iterations );
+      m_full_target_error = std::max( m_full_target_error, test_sim -> target_error );
     }
     catch ( const std::exception& e )
     {
@@ -602,9 +831,17 @@ bool profilesets_t::parse( sim_t* sim )
       return false;
     }
 
+    // Profilesets that write their own reports, or collect output data, are always simulated
+    std::string cache_key;
+    if ( ! sim -> profileset_cache.empty() && ! has_output_opts && sim -> profileset_output_data.empty() )
+    {
+      cache_key = result_cache_key( control );
+    }
+
     m_mutex.lock();
     m_profilesets.push_back( std::make_unique<profile_set_t>(
         profileset_name, control, has_output_opts ) );
+    m_profilesets.back() -> cache_key( std::move( cache_key ) );
     m_control.notify_one();
     m_mutex.unlock();
   }
@@ -737,6 +974,20 @@ bool profilesets_t::iterate( sim_t* parent )
 
   m_start_time = chrono::wall_clock::now();
 
+  // With racing, the first round runs all profilesets with few iterations
+  if ( parent -> profileset_racing_top > 0 &&
+       as<size_t>( parent -> profileset_racing_top ) < parent -> profileset_map.size() )
+  {
+    m_round_iterations = std::max( parent -> profileset_racing_iterations, 2 );
+  }
+
+  open_cache( parent );
+
+  if ( m_mode == PARALLEL )
+  {
+    start_workers( parent );
+  }
+
   while ( ! is_done() )
   {
     m_control_lock.lock();
@@ -761,13 +1012,20 @@ bool profilesets_t::iterate( sim_t* parent )
 
     m_control_lock.unlock();
 
-    generate_work( parent, set );
+    generate_work( parent, *set );
   }
 
   // Wait until the tail-end of the parallel work has been done. Non-parallel processing mode will
   // not need to finalize any work (all work has been done by the loop above)
   finalize_work();
 
+  if ( m_round_iterations > 0 )
+  {
+    race( parent );
+  }
+
+  stop_workers();
+
   // Output profileset progressbar whenever we finish anything
   output_progressbar( parent );
 
@@ -781,9 +1039,261 @@ bool profilesets_t::iterate( sim_t* parent )
   return true;
 }
 
-void profilesets_t::notify_worker()
+// Run racing rounds after the first one, until at most profileset_racing_top profilesets remain
+// or the next round would be as long as a full run. Each round drops the profilesets that can no
+// longer reach the top, and doubles the iterations for the rest. The profilesets still in the race
+// then get a full run, so their results are as accurate as without racing. Rounds and the full run
+// continue from the iterations a profileset already ran (see simulate_profileset()).
+void profilesets_t::race( sim_t* parent )
+{
+  std::vector<profile_set_t*> contenders;
+  range::transform( m_profilesets, std::back_inserter( contenders ), []( const profileset_entry_t& p ) {
+    return p.get();
+  } );
+
+  while ( m_round_iterations > 0 && ! parent -> is_canceled() )
+  {
+    eliminate( parent, contenders );
+
+    m_round_iterations = next_round_iterations( parent, contenders );
+
+    for ( auto set : contenders )
+    {
+      if ( parent -> is_canceled() )
+      {
+        break;
+      }
+
+      generate_work( parent, *set );
+    }
+
+    finalize_work();
+  }
+
+  m_round_iterations = 0;
+}
+
+// Drop profilesets whose confidence interval on the primary metric lies entirely below the lower
+// end of the confidence interval of the profileset ranked profileset_racing_top
+void profilesets_t::eliminate( const sim_t* parent, std::vector<profile_set_t*>& contenders ) const
+{
+  auto top = as<size_t>( parent -> profileset_racing_top );
+  if ( contenders.size() <= top )
+  {
+    return;
+  }
+
+  auto bound = [ parent ]( const profile_set_t* set, double direction ) {
+    const auto& result = set -> result();
+    return result.mean() + direction * result.mean_stddev() * parent -> confidence_estimator;
+  };
+
+  std::vector<double> lower_bounds;
+  range::transform( contenders, std::back_inserter( lower_bounds ), [ &bound ]( const profile_set_t* set ) {
+    return bound( set, -1.0 );
+  } );
+  std::nth_element( lower_bounds.begin(), lower_bounds.begin() + ( top - 1 ), lower_bounds.end(),
+                    std::greater<>() );
+  double threshold = lower_bounds[ top - 1 ];
+
+  range::erase_remove( contenders, [ &bound, threshold ]( profile_set_t* set ) {
+    if ( bound( set, 1.0 ) >= threshold )
+    {
+      return false;
+    }
+
+    set -> eliminated_at( set -> result().iterations() );
+    set -> cleanup_options();
+    set -> cleanup_racing_data();
+    return true;
+  } );
+}
+
+// Iterations of the next racing round, or 0 if the remaining profilesets should get a full run
+int profilesets_t::next_round_iterations( const sim_t* parent, const std::vector<profile_set_t*>& contenders ) const
+{
+  if ( contenders.size() <= as<size_t>( parent -> profileset_racing_top ) )
+  {
+    return 0;
+  }
+
+  int iterations = m_round_iterations * 2;
+  if ( iterations >= m_full_iterations )
+  {
+    return 0;
+  }
+
+  // With a target error, stop racing once all profilesets reach it
+  if ( m_full_target_error > 0 )
+  {
+    bool converged = std::all_of( contenders.begin(), contenders.end(), [ this, parent ]( const profile_set_t* set ) {
+      const auto& result = set -> result();
+      return result.mean() != 0 &&
+             100.0 * result.mean_stddev() * parent -> confidence_estimator / result.mean() <= m_full_target_error;
+    } );
+
+    if ( converged )
+    {
+      return 0;
+    }
+  }
+
+  return iterations;
+}
+
+// Load earlier results from the result cache file, and open it for appending new results. Each line
+// holds the results of one metric of a profileset: cache key, metric, iterations, mean, min, max,
+// stddev, mean_stddev, median, first_quartile, third_quartile, and paired_mean_stddev. Lines that
+// do not parse (e.g., partially written ones) are ignored, later lines replace earlier ones.
+void profilesets_t::open_cache( sim_t* parent )
+{
+  if ( parent -> profileset_cache.empty() )
+  {
+    return;
+  }
+
+  io::ifstream in;
+  in.open( parent -> profileset_cache );
+
+  std::string line;
+  while ( in.is_open() && std::getline( in, line ) )
+  {
+    auto fields = util::string_split<util::string_view>( line, " " );
+    if ( fields.size() != 12 )
+    {
+      continue;
+    }
+
+    auto metric = util::parse_scale_metric( fields[ 1 ] );
+    if ( metric == SCALE_METRIC_NONE )
+    {
+      continue;
+    }
+
+    profile_result_t result( metric );
+    try
+    {
+      result.iterations( util::to_unsigned( fields[ 2 ] ) )
+        .mean( util::to_double( fields[ 3 ] ) )
+        .min( util::to_double( fields[ 4 ] ) )
+        .max( util::to_double( fields[ 5 ] ) )
+        .stddev( util::to_double( fields[ 6 ] ) )
+        .mean_stddev( util::to_double( fields[ 7 ] ) )
+        .median( util::to_double( fields[ 8 ] ) )
+        .first_quartile( util::to_double( fields[ 9 ] ) )
+        .third_quartile( util::to_double( fields[ 10 ] ) )
+        .paired_mean_stddev( util::to_double( fields[ 11 ] ) );
+    }
+    catch ( const std::exception& )
+    {
+      continue;
+    }
+
+    auto& results = m_cache[ std::string( fields[ 0 ] ) ];
+    auto it = range::find( results, metric, &profile_result_t::metric );
+    if ( it != results.end() )
+    {
+      *it = result;
+    }
+    else
+    {
+      results.push_back( result );
+    }
+  }
+
+  m_cache_baseline_key = baseline_cache_key( parent );
+
+  m_cache_out = std::make_unique<io::ofstream>();
+  m_cache_out -> open( parent -> profileset_cache, io::ofstream::out | io::ofstream::app );
+  if ( ! m_cache_out -> is_open() )
+  {
+    parent -> error( "Unable to open profileset cache '{}', profileset results will not be cached",
+                     parent -> profileset_cache );
+    m_cache_out.reset();
+  }
+}
+
+// Use cached results for the profileset, if all profileset metrics are cached. Only used for full
+// runs, racing rounds are always simulated.
+bool profilesets_t::load_cached_result( const sim_t* parent, profile_set_t& set ) const
+{
+  if ( set.cache_key().empty() )
+  {
+    return false;
+  }
+
+  auto it = m_cache.find( cache_key( set ) );
+  if ( it == m_cache.end() )
+  {
+    return false;
+  }
+
+  const auto& results = it -> second;
+  auto missing = range::any_of( parent -> profileset_metric, [ &results ]( scale_metric_e metric ) {
+    return ! range::contains( results, metric, &profile_result_t::metric );
+  } );
+
+  if ( missing )
+  {
+    return false;
+  }
+
+  range::for_each( results, [ &set ]( const profile_result_t& result ) {
+    set.result( result.metric() ) = result;
+  } );
+
+  set.cleanup_options();
+
+  return true;
+}
+
+// Cache key of the results of a profileset in this run
+std::string profilesets_t::cache_key( const profile_set_t& set ) const
+{
+  return set.cache_key() + m_cache_baseline_key;
+}
+
+void profilesets_t::unpaired_result( sim_t* parent, const profile_set_t& set, size_t iterations,
+                                     size_t baseline_iterations )
+{
+  if ( m_unpaired_warned.exchange( true ) )
+  {
+    return;
+  }
+
+  parent -> error( "Profileset '{}' has {} iterations against {} of the baseline, which cannot be paired for "
+                   "common_random_numbers. Its error is reported unpaired (no paired_mean_stddev), as may be "
+                   "the case for further profilesets.",
+                   set.name(), iterations, baseline_iterations );
+}
+
+void profilesets_t::cache_result( const sim_t* parent, const profile_set_t& set )
 {
-  m_work.notify_one();
+  if ( ! m_cache_out || set.cache_key().empty() || m_round_iterations > 0 || parent -> is_canceled() )
+  {
+    return;
+  }
+
+  fmt::memory_buffer record;
+  for ( auto metric : parent -> profileset_metric )
+  {
+    const auto& result = set.result( metric );
+    if ( result.iterations() == 0 )
+    {
+      return;
+    }
+
+    fmt::format_to( std::back_inserter( record ), "{} {} {} {:.17g} {:.17g} {:.17g} {:.17g} {:.17g} {:.17g} {:.17g} {:.17g} {:.17g}\n",
+                    cache_key( set ), util::scale_metric_type_abbrev( metric ), result.iterations(),
+                    result.mean(), result.min(), result.max(), result.stddev(), result.mean_stddev(),
+                    result.median(), result.first_quartile(), result.third_quartile(),
+                    result.paired_mean_stddev() );
+  }
+
+  // Write and flush each profileset in one go, so an interrupted run keeps all finished profilesets
+  std::lock_guard<std::mutex> lock( m_cache_mutex );
+  m_cache_out -> write( record.data(), as<std::streamsize>( record.size() ) );
+  m_cache_out -> flush();
 }
 
 int profilesets_t::max_name_length() const
@@ -954,6 +1464,9 @@ void create_options( sim_t* sim )
 
   sim -> add_option( opt_int( "profileset_work_threads", sim -> profileset_work_threads ) );
   sim -> add_option( opt_int( "profileset_init_threads", sim -> profileset_init_threads ) );
+  sim -> add_option( opt_int( "profileset_racing_top", sim -> profileset_racing_top, 0, std::numeric_limits<int>::max() ) );
+  sim -> add_option( opt_string( "profileset_cache", sim -> profileset_cache ) );
+  sim -> add_option( opt_int( "profileset_racing_iterations", sim -> profileset_racing_iterations, 2, std::numeric_limits<int>::max() ) );
 }
 
 statistical_data_t collect( const extended_sample_data_t& c )
@@ -962,26 +1475,41 @@ statistical_data_t collect( const extended_sample_data_t& c )
            c.percentile( 0.75 ), c.max(), c.std_dev, c.mean_std_dev };
 }
 
+const extended_sample_data_t* metric_sample_data( const player_t* player, scale_metric_e metric )
+{
+  const auto& d = player -> collected_data;
+
+  switch ( metric )
+  {
+    case SCALE_METRIC_DPS:       return &d.dps;
+    case SCALE_METRIC_DPSE:      return &d.dpse;
+    case SCALE_METRIC_HPS:       return &d.hps;
+    case SCALE_METRIC_HPSE:      return &d.hpse;
+    case SCALE_METRIC_APS:       return &d.aps;
+    case SCALE_METRIC_DPSP:      return &d.prioritydps;
+    case SCALE_METRIC_DTPS:      return &d.dtps;
+    case SCALE_METRIC_DMG_TAKEN: return &d.dmg_taken;
+    case SCALE_METRIC_HTPS:      return &d.htps;
+    case SCALE_METRIC_TMI:       return &d.theck_meloree_index;
+    case SCALE_METRIC_ETMI:      return &d.effective_theck_meloree_index;
+    case SCALE_METRIC_DEATHS:    return &d.deaths;
+    case SCALE_METRIC_TIME:      return &d.fight_length;
+    case SCALE_METRIC_RAID_DPS:  return &player->sim->raid_dps;
+    default:                     return nullptr;
+  }
+}
+
 statistical_data_t metric_data( const player_t* player, scale_metric_e metric )
 {
   const auto& d = player -> collected_data;
 
+  if ( auto data = metric_sample_data( player, metric ) )
+  {
+    return collect( *data );
+  }
+
   switch ( metric )
   {
-    case SCALE_METRIC_DPS:       return collect( d.dps );
-    case SCALE_METRIC_DPSE:      return collect( d.dpse );
-    case SCALE_METRIC_HPS:       return collect( d.hps );
-    case SCALE_METRIC_HPSE:      return collect( d.hpse );
-    case SCALE_METRIC_APS:       return collect( d.aps );
-    case SCALE_METRIC_DPSP:      return collect( d.prioritydps );
-    case SCALE_METRIC_DTPS:      return collect( d.dtps );
-    case SCALE_METRIC_DMG_TAKEN: return collect( d.dmg_taken );
-    case SCALE_METRIC_HTPS:      return collect( d.htps );
-    case SCALE_METRIC_TMI:       return collect( d.theck_meloree_index );
-    case SCALE_METRIC_ETMI:      return collect( d.effective_theck_meloree_index );
-    case SCALE_METRIC_DEATHS:    return collect( d.deaths );
-    case SCALE_METRIC_TIME:      return collect( d.fight_length );
-    case SCALE_METRIC_RAID_DPS:  return collect( player->sim->raid_dps );
     case SCALE_METRIC_HAPS:
     {
       auto hps = collect( d.hps );
@@ -6,14 +6,17 @@
 #define SC_PROFILESET_HH
 
 #include <array>
+#include <atomic>
 #include <memory>
 #include <vector>
 #include <string>
+#include <unordered_map>
 
 #ifndef SC_NO_THREADING
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <deque>
 #endif
 
 #include "option.hpp"
@@ -26,6 +29,9 @@ struct sim_control_t;
 struct player_t;
 class extended_sample_data_t;
 struct talent_data_t;
+namespace io {
+class ofstream;
+}
 
 
 namespace profileset
@@ -55,15 +61,17 @@ class profile_result_t
   double         m_3rdquartile;
   double         m_stddev;
   double         m_mean_stddev;
+  // Standard deviation of the mean difference to the baseline actor, with common random numbers
+  double         m_paired_mean_stddev;
   size_t         m_iterations;
 
 public:
   profile_result_t() : m_metric( SCALE_METRIC_NONE ), m_mean( 0 ), m_median( 0 ), m_min( 0 ),
-    m_max( 0 ), m_1stquartile( 0 ), m_3rdquartile( 0 ), m_stddev( 0 ), m_mean_stddev(0), m_iterations( 0 )
+    m_max( 0 ), m_1stquartile( 0 ), m_3rdquartile( 0 ), m_stddev( 0 ), m_mean_stddev(0), m_paired_mean_stddev( 0 ), m_iterations( 0 )
   { }
 
   profile_result_t( scale_metric_e m ) : m_metric( m ), m_mean( 0 ), m_median( 0 ), m_min( 0 ),
-    m_max( 0 ), m_1stquartile( 0 ), m_3rdquartile( 0 ), m_stddev( 0 ), m_mean_stddev(0), m_iterations( 0 )
+    m_max( 0 ), m_1stquartile( 0 ), m_3rdquartile( 0 ), m_stddev( 0 ), m_mean_stddev(0), m_paired_mean_stddev( 0 ), m_iterations( 0 )
   { }
 
   scale_metric_e metric() const
@@ -121,6 +129,12 @@ public:
     m_mean_stddev = v; return *this;
   }
 
+  double paired_mean_stddev() const
+  { return m_paired_mean_stddev; }
+
+  profile_result_t& paired_mean_stddev( double v )
+  { m_paired_mean_stddev = v; return *this; }
+
   size_t iterations() const
   { return m_iterations; }
 
@@ -383,6 +397,13 @@ class profile_set_t
   bool                                   m_has_output;
   std::vector<profile_result_t>          m_results;
   std::unique_ptr<profile_output_data_t> m_output_data;
+  size_t                                 m_eliminated_at; // Iterations when dropped from racing
+  std::string                            m_cache_key;     // Result cache key, empty if not cached
+
+  // Racing: iterations run in earlier rounds, and the per iteration values they collected for each
+  // profileset metric (in parent profileset_metric order), continued by the next round
+  int                                    m_racing_iterations;
+  std::vector<std::vector<double>>       m_racing_data;
 
 public:
   profile_set_t( std::string name, sim_control_t* opts, bool has_output );
@@ -406,6 +427,30 @@ public:
   size_t results() const
   { return m_results.size(); }
 
+  size_t eliminated_at() const
+  { return m_eliminated_at; }
+
+  profile_set_t& eliminated_at( size_t iterations )
+  { m_eliminated_at = iterations; return *this; }
+
+  int racing_iterations() const
+  { return m_racing_iterations; }
+
+  const std::vector<std::vector<double>>& racing_data() const
+  { return m_racing_data; }
+
+  profile_set_t& racing_data( int iterations, std::vector<std::vector<double>> data )
+  { m_racing_iterations = iterations; m_racing_data = std::move( data ); return *this; }
+
+  void cleanup_racing_data()
+  { racing_data( 0, {} ); }
+
+  const std::string& cache_key() const
+  { return m_cache_key; }
+
+  profile_set_t& cache_key( std::string key )
+  { m_cache_key = std::move( key ); return *this; }
+
   profile_output_data_t& output_data()
   {
     if ( ! m_output_data )
@@ -417,28 +462,21 @@ public:
   }
 };
 
+// Thread of the parallel profileset worker pool. Runs queued profilesets one after another until the
+// profileset driver stops the pool. Sims are not reused: like in sequential mode, every profileset
+// is set up and simulated by a new sim.
 class worker_t
 {
-  bool           m_done;
   sim_t*         m_parent;
   profilesets_t* m_master;
-
-  sim_t*         m_sim;
-  profile_set_t* m_profileset;
-  std::thread*   m_thread;
+  std::thread    m_thread;
 
 public:
-  worker_t( profilesets_t*, sim_t*, profile_set_t* );
-  ~worker_t();
+  worker_t( profilesets_t*, sim_t* );
 
   const std::thread& thread() const;
   std::thread& thread();
   void execute();
-
-  bool is_done() const
-  { return m_done == true; }
-
-  sim_t* sim() const;
 };
 #endif
 
@@ -477,9 +515,13 @@ private:
   // Shared iterator for threaded init workers
   opts::map_list_t::const_iterator       m_init_index;
 
-  // Parallel profileset worker information
+  // Parallel profileset worker information, profilesets waiting for a worker and the number of
+  // profilesets being simulated
   size_t                                 m_max_workers;
-  std::vector<std::unique_ptr<worker_t>> m_current_work;
+  std::vector<std::unique_ptr<worker_t>> m_workers;
+  std::deque<profile_set_t*>             m_queue;
+  size_t                                 m_busy;
+  bool                                   m_shutdown;
 
   // Parallel profileset worker control
   std::mutex                             m_work_mutex;
@@ -489,6 +531,23 @@ private:
   // Parallel profileset stats collection
   chrono::wall_clock::time_point         m_start_time;
   chrono::wall_clock::duration           m_total_elapsed;
+
+  // Racing, iterations of the current round (0 for a full run) and the iteration count and target
+  // error of a full run
+  int                                    m_round_iterations;
+  int                                    m_full_iterations;
+  double                                 m_full_target_error;
+
+  // Result cache, results loaded from the cache file by cache key, and the output stream new results
+  // are appended to
+  std::unordered_map<std::string, std::vector<profile_result_t>> m_cache;
+  std::unique_ptr<io::ofstream>          m_cache_out;
+  std::mutex                             m_cache_mutex;
+  // Suffix of cache keys identifying the seed and baseline results, with common random numbers
+  std::string                            m_cache_baseline_key;
+
+  // A result without paired error has been reported
+  std::atomic<bool>                      m_unpaired_warned;
 #endif
 
   int max_name_length() const;
@@ -498,10 +557,19 @@ private:
   void set_state( state new_state );
 
   size_t n_workers() const;
-  void generate_work( sim_t*, std::unique_ptr<profile_set_t>& );
-  void cleanup_work();
+  void start_workers( sim_t* );
+  void stop_workers();
+  void generate_work( sim_t*, profile_set_t& );
   void finalize_work();
 
+  void race( sim_t* );
+  void eliminate( const sim_t*, std::vector<profile_set_t*>& contenders ) const;
+  int next_round_iterations( const sim_t*, const std::vector<profile_set_t*>& contenders ) const;
+
+  void open_cache( sim_t* );
+  bool load_cached_result( const sim_t*, profile_set_t& ) const;
+  std::string cache_key( const profile_set_t& ) const;
+
   sim_control_t* create_sim_options( const sim_control_t*, const std::vector<std::string>& opts, unsigned main_actor_index );
 public:
   profilesets_t();
@@ -514,8 +582,21 @@ public:
 
   size_t done_profilesets() const;
 
-  // Worker sim finished
-  void notify_worker();
+  // Next profileset for a worker to simulate, or nullptr when the worker should exit
+  profile_set_t* next_work();
+
+  // Worker finished simulating a profileset
+  void finish_work( const sim_t* );
+
+  // Warn (once per run) that a profileset result could not be paired with the baseline under
+  // common random numbers, as the iteration counts differ
+  void unpaired_result( sim_t*, const profile_set_t&, size_t iterations, size_t baseline_iterations );
+
+  // Append the results of a fully simulated profileset to the result cache
+  void cache_result( const sim_t*, const profile_set_t& );
+
+  // Iterations of the current racing round, 0 for a full run
+  int round_iterations() const;
 
   std::string current_profileset_name();
 
@@ -541,6 +622,8 @@ void create_options( sim_t* sim );
 
 statistical_data_t collect( const extended_sample_data_t& c );
 statistical_data_t metric_data( const player_t* player, scale_metric_e metric );
+// Per iteration data of a metric, nullptr if the metric is combined from several
+const extended_sample_data_t* metric_sample_data( const player_t* player, scale_metric_e metric );
 void save_output_data( profile_set_t& profileset, const player_t* parent_player, const player_t* player, const std::string& option );
 
 // Filter non-profilest options into a new control object, caller is responsible for deleting the
@@ -1939,6 +1939,7 @@ void raid_event_t::combat_begin()
     else if ( sim->current_iteration == 0 || sim->fixed_time )
     {
       // There is no resource callback from fluffy pillow in these circumstances, thus use time based events as well.
+      // This depends on the target health estimate of iteration 0, not on whether the iteration is collected.
       timespan_t end_time = ( 1.0 - last_pct / 100.0 ) * sim->expected_iteration_time;
       end_event = make_event<end_event_t>( *sim, *sim, this, end_time );
     }
@@ -1962,6 +1963,7 @@ void raid_event_t::combat_begin()
     else if ( sim->current_iteration == 0 || sim->fixed_time )
     {
       // There is no resource callback from fluffy pillow in these circumstances, thus use time based events as well.
+      // This depends on the target health estimate of iteration 0, not on whether the iteration is collected.
       timespan_t start_time = ( 1.0 - first_pct / 100.0 ) * sim->expected_iteration_time;
       start_event = make_event<start_event_t>( *sim, *sim, this, start_time, "first_pct reached" );
     }
@@ -295,16 +295,23 @@ void scale_factor_control_t::analyze_stats()
       for ( scale_metric_e sm = SCALE_METRIC_NONE; sm < SCALE_METRIC_MAX; sm++ )
       {
 
-        double delta_score = delta_p -> scaling_for_metric( sm ).value;
-        double   ref_score = ref_p -> scaling_for_metric( sm ).value;
+        auto delta_metric = delta_p -> scaling_for_metric( sm );
+        auto   ref_metric = ref_p -> scaling_for_metric( sm );
 
-        double delta_error = delta_p -> scaling_for_metric( sm ).stddev * delta_sim -> confidence_estimator;
-        double   ref_error = ref_p -> scaling_for_metric( sm ).stddev * ref_sim -> confidence_estimator;
+        double delta_score = delta_metric.value;
+        double   ref_score = ref_metric.value;
+
+        double delta_error = delta_metric.stddev * delta_sim -> confidence_estimator;
+        double   ref_error = ref_metric.stddev * ref_sim -> confidence_estimator;
 
         double score = ( delta_score - ref_score ) / divisor;
         double error = delta_error * delta_error + ref_error * ref_error;
 
-        if ( error > 0 )
+        // With common random numbers, the error of the difference comes from the paired iterations
+        double paired_stddev = 0;
+        if ( sim -> common_random_numbers && paired_mean_stddev( delta_metric, ref_metric, paired_stddev ) )
+          error = paired_stddev * delta_sim -> confidence_estimator;
+        else if ( error > 0 )
           error = sqrt( error );
 
         error = fabs( error / divisor );
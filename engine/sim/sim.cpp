@@ -22,6 +22,7 @@
 #include "profileset.hpp"
 #include "sim/event.hpp"
 #include "sim/iteration_data_entry.hpp"
+#include "sim/iteration_data_file.hpp"
 #include "sim/plot.hpp"
 #include "sim/raid_event.hpp"
 #include "sim/reforge_plot.hpp"
@@ -39,12 +40,16 @@
 #include <iostream>
 #include <random>
 #include <sstream>
+#include <unordered_map>
 #ifdef SC_WINDOWS
 #include <direct.h>
 #endif
 
 namespace { // UNNAMED NAMESPACE ============================================
 
+// Chart data capture of the calling thread, see sim_t::chart_capture_t
+thread_local sim_t::chart_data_t* captured_chart_data = nullptr;
+
 // Comparator for iteration data entry sorting (see analyze_iteration_data)
 bool iteration_data_cmp( const iteration_data_entry_t& a,
                          const iteration_data_entry_t& b )
@@ -1029,7 +1034,7 @@ struct resource_timeline_collect_event_t : public event_t
   { return "resource_timeline_collect_event_t"; }
   void execute() override
   {
-    if ( sim().iterations == 1 || sim().current_iteration > 0 )
+    if ( sim().collect_iteration() )
     {
       if ( ! sim().single_actor_batch )
       {
@@ -1406,25 +1411,6 @@ struct compare_name
 
 } // UNNAMED NAMESPACE ===================================================
 
-// Standard progress method, normal mode sims use the single (first) index, single actor batch
-// sims progress with the main thread's current index.
-sim_progress_t work_queue_t::progress( int idx )
-{
-  G l(m);
-  size_t current_index = idx;
-  if ( idx < 0 )
-  {
-    current_index = index;
-  }
-
-  if ( current_index >= _total_work.size() )
-  {
-    return sim_progress_t{ _work.back(), _projected_work.back() };
-  }
-
-  return sim_progress_t{ _work[ current_index ], _projected_work[ current_index ] };
-}
-
 // ==========================================================================
 // Simulator
 // ==========================================================================
@@ -1449,6 +1435,7 @@ sim_t::sim_t()
     vary_combat_length( 0.0 ),
     current_iteration( -1 ),
     iterations( 0 ),
+    buff_stack_generation( 1 ),
     target_error( 0 ),
     target_error_role( ROLE_DPS ),
     current_error( 0 ),
@@ -1497,6 +1484,7 @@ sim_t::sim_t()
     optimal_raid( 0 ),
     log( 0 ),
     debug_each( 0 ),
+    verify_reset( false ),
     normalized_stat( STAT_NONE ),
     default_region_str( "us" ),
     save_prefix_str( "save_" ),
@@ -1542,6 +1530,10 @@ sim_t::sim_t()
     seed( 0 ),
     deterministic( 0 ),
     strict_work_queue( 0 ),
+    common_random_numbers( false ),
+    iteration_seed( 0 ),
+    iteration_offset( 0 ),
+    iteration_total( 0 ),
     average_range( true ),
     average_gauss( false ),
     fight_style(),
@@ -1588,6 +1580,7 @@ sim_t::sim_t()
     save_raid_summary( 0 ),
     save_gear_comments( 0 ),
     statistics_level( 1 ),
+    statistics_sketch_accuracy( 0 ),
     separate_stats_by_actions( 0 ),
     report_raid_summary( 0 ),
     buff_uptime_timeline( 1 ),
@@ -1609,6 +1602,9 @@ sim_t::sim_t()
     merge_enemy_priority_dmg( false ),
     // Multi-Threading
     threads( 0 ),
+    merge_ready( false ),
+    merged( false ),
+    simulation_end(),
     thread_index( 0 ),
     process_priority( computer_process::BELOW_NORMAL ),
     work_queue( new work_queue_t() ),
@@ -1631,6 +1627,9 @@ sim_t::sim_t()
     profileset_enabled( false ),
     profileset_work_threads( 0 ),
     profileset_init_threads( 1 ),
+    profileset_racing_top( 0 ),
+    profileset_racing_iterations( 500 ),
+    profileset_cache(),
     profilesets( std::make_unique<profileset::profilesets_t>() )
 {
   item_db_sources.assign( std::begin( default_item_db_sources ), std::end( default_item_db_sources ) );
@@ -1714,9 +1713,18 @@ double sim_t::iteration_time_adjust()
   if ( iterations <= 1 )
     return 1.0;
 
-  if ( current_iteration == 0 )
+  if ( current_iteration == 0 && !collect_iteration() )
     return 1.0;
 
+  // Deterministic runs vary the length by the global iteration, so an iteration has the same length
+  // regardless of the thread count
+  if ( deterministic )
+  {
+    int iteration = global_iteration();
+    return 1.0 + vary_combat_length * ( ( iteration % 2 ) ? 1 : -1 ) *
+                     std::min( 1.0, iteration / static_cast<double>( std::max( 1, iteration_total ) ) );
+  }
+
   // Approximate uniform distribution for fight lengths through randomization when target error is
   // used. Will generate more fair fight length distribution when reasonable (<0.5) target_error
   // values are chosen, and removes issues with pathological cases where high values are used (high
@@ -1733,6 +1741,28 @@ double sim_t::iteration_time_adjust()
   }
 }
 
+// sim_t::global_iteration ==================================================
+
+/// Index of the current iteration over all threads (per actor batch). Only meaningful with a fixed
+/// split of iterations between threads, i.e. deterministic runs or a strict work queue.
+int sim_t::global_iteration() const
+{
+  int batch = single_actor_batch ? as<int>( current_index ) : 0;
+  return iteration_offset + current_iteration - batch * iterations;
+}
+
+// sim_t::collect_iteration =================================================
+
+/// Whether data is collected for the current iteration. The first iteration of each thread warms up
+/// the sim (with fixed_time=0 it estimates the target health) and is discarded. Deterministic fixed
+/// time runs collect it, as discarding an iteration per thread would make their results depend on
+/// the thread count. The target health estimate is still kept per thread, so runs where the target
+/// health decides the iteration length (fixed_time=0) depend on the thread count regardless.
+bool sim_t::collect_iteration() const
+{
+  return iterations == 1 || current_iteration > 0 || ( deterministic && fixed_time );
+}
+
 // sim_t::expected_max_time =================================================
 
 double sim_t::expected_max_time() const
@@ -1791,9 +1821,13 @@ void sim_t::cancel()
 
   canceled = true;
 
-  for (auto & relative : relatives)
+  // Profileset workers create and delete relatives concurrently, and may cancel the sim themselves
   {
-    relative -> cancel();
+    AUTO_LOCK( relatives_mutex );
+    for (auto & relative : relatives)
+    {
+      relative -> cancel();
+    }
   }
 
   if ( ! parent )
@@ -1852,8 +1886,10 @@ void sim_t::reset()
 {
   print_debug( "Resetting Simulator" );
 
-  if( deterministic )
-    seed = rng().reseed();
+  // Deterministic runs seed each iteration like common random numbers, so results do not depend on
+  // the thread count. Actor streams are keyed by a unique id, not the name (see seed_iteration).
+  if ( common_random_numbers || deterministic )
+    seed_iteration();
 
   event_mgr.reset();
 
@@ -1893,6 +1929,32 @@ void sim_t::reset()
   raid_event_t::reset( this );
 }
 
+/// Seed the sim and actor streams for the current iteration, for deterministic runs and common
+/// random numbers. Every iteration reseeds the sim stream and the stream of every actor. Iterations
+/// are numbered over all threads (per actor batch), so an iteration draws the same numbers
+/// regardless of the thread count. Actor streams are keyed by a portable hash of the name (pets by
+/// owner and pet name, and by creation order among same-named pets), so an actor draws the same
+/// numbers no matter which other, differently named actors exist, and on every platform.
+void sim_t::seed_iteration()
+{
+  int batch = single_actor_batch ? as<int>( current_index ) : 0;
+  iteration_seed = rng::stream_seed( rng::stream_seed( seed, batch ), global_iteration() );
+
+  _rng.seed( iteration_seed );
+  _rng.reset();
+
+  // Actors created since the last iteration (e.g., dynamic pets) get their stream number first
+  for ( size_t i = actor_stream_ids.size(); i < actor_list.size(); ++i )
+  {
+    actor_stream_ids.push_back( actor_stream_names.next( actor_list[ i ]->name() ) );
+  }
+
+  for ( size_t i = 0; i < actor_list.size(); ++i )
+  {
+    actor_list[ i ]->seed_rng( rng::stream_seed( iteration_seed, actor_stream_ids[ i ] ) );
+  }
+}
+
 /// Start combat.
 void sim_t::combat_begin()
 {
@@ -1919,7 +1981,7 @@ void sim_t::combat_begin()
 
   reset();
 
-  // Debug seed needs to be done _after_ sim reset, because deterministic=1 will reseed in
+  // Debug seed needs to be done _after_ sim reset, because deterministic=1 seeds the iteration in
   // sim_t::reset()
   if ( !debug_seed.empty() )
   {
@@ -2042,7 +2104,7 @@ void sim_t::combat_end()
     b -> expire();
   }
 
-  if ( iterations == 1 || current_iteration >= 1 )
+  if ( collect_iteration() )
     datacollection_end();
 
   //assert( active_enemies == 0 );
@@ -2130,12 +2192,17 @@ void sim_t::datacollection_end()
   total_absorb.add( iteration_absorb );
   raid_aps.add( current_time() != timespan_t::zero() ? iteration_absorb / current_time().total_seconds() : 0 );
 
-  if ( deterministic && report_iteration_data > 0 && current_iteration > 0 &&
+  if ( iteration_data_writer )
+  {
+    iteration_data_writer -> collect();
+  }
+
+  if ( deterministic && report_iteration_data > 0 && collect_iteration() &&
        current_time() > timespan_t::zero() )
   {
     // TODO: Metric should be selectable
     iteration_data_entry_t entry( iteration_dmg / current_time().total_seconds(),
-        current_time().total_seconds(), seed, current_iteration );
+        current_time().total_seconds(), iteration_seed, global_iteration() );
     for ( auto* t : target_list )
     {
        // Once we start hitting adds (instead of real enemies), break out as those don't have real
@@ -2733,7 +2800,13 @@ void sim_t::init()
       seed  = uint64_t(rd()) | (uint64_t(rd()) << 32);
     }
   }
-  _rng.seed( seed + thread_index );
+  // Threads draw from non-overlapping substreams of the seed
+  _rng.seed( seed );
+  for ( int i = 0; i < thread_index; ++i )
+  {
+    _rng.long_jump();
+  }
+  iteration_seed = seed;
 
   if (   queue_lag_stddev == timespan_t::zero() )   queue_lag_stddev =   queue_lag * 0.25;
   if (     gcd_lag_stddev == timespan_t::zero() )     gcd_lag_stddev =     gcd_lag * 0.25;
@@ -3000,8 +3073,11 @@ void sim_t::analyze()
 
   raid_dps.analyze();
 
-  for ( size_t i = 0; i < buff_list.size(); ++i )
-    buff_list[ i ] -> analyze();
+  // Analysis is independent per buff, stats object, timeline, etc., so it is split over the sim
+  // threads. Actors are analyzed together with their pets, as an owner analyzes its pets' stats.
+  unsigned analyze_threads = as<unsigned>( std::max( 1, threads ) );
+
+  thread::parallel_for( buff_list.size(), analyze_threads, [ this ]( size_t i ) { buff_list[ i ]->analyze(); } );
 
   if ( scaling -> scale_stat == STAT_NONE &&
        scaling -> calculate_scale_factors == 0 &&
@@ -3018,14 +3094,39 @@ void sim_t::analyze()
 
   // Run core analyze for all actor collected data before proceeding to full analysis. This is to prevent errors from
   // when actors access information from each other, e.g. buffs.
-  for ( size_t i = 0; i < actor_list.size(); i++ )
-  {
+  thread::parallel_for( actor_list.size(), analyze_threads, [ this ]( size_t i ) {
     actor_list[ i ] -> pre_analyze_hook();
     actor_list[ i ] -> collected_data.analyze( *actor_list[ i ] );
+  } );
+
+  std::vector<std::vector<player_t*>> actor_groups;
+  std::unordered_map<const player_t*, size_t> group_index;
+  for ( auto actor : actor_list )
+  {
+    const player_t* owner = actor;
+    while ( owner -> is_pet() )
+      owner = owner -> cast_pet() -> owner;
+
+    auto it = group_index.emplace( owner, actor_groups.size() ).first;
+    if ( it -> second == actor_groups.size() )
+      actor_groups.emplace_back();
+
+    actor_groups[ it -> second ].push_back( actor );
   }
 
-  for ( size_t i = 0; i < actor_list.size(); i++ )
-    actor_list[ i ] -> analyze( *this );
+  thread::parallel_for( actor_groups.size(), analyze_threads, [ this, &actor_groups ]( size_t i ) {
+    for ( auto actor : actor_groups[ i ] )
+      actor -> analyze( *this );
+  } );
+
+  // Actors add themselves to the actor lists as they finish, restore the actor list order before sorting
+  auto actor_order = []( const player_t* l, const player_t* r ) { return l -> actor_index < r -> actor_index; };
+  for ( auto list : { &players_by_dps, &players_by_priority_dps, &players_by_hps, &players_by_hps_plus_aps,
+                      &players_by_dtps, &players_by_tmi, &players_by_name, &players_by_apm, &players_by_variance,
+                      &targets_by_name } )
+  {
+    range::sort( *list, actor_order );
+  }
 
   raid_event_t::analyze( this );
 
@@ -3095,6 +3196,11 @@ bool sim_t::iterate()
 
   progress_bar.init();
 
+  if ( iteration_data_file )
+  {
+    iteration_data_writer = std::make_unique<iteration_data_writer_t>( *this, *iteration_data_file );
+  }
+
   activate_actors();
 
   bool more_work = true;
@@ -3138,6 +3244,11 @@ bool sim_t::iterate()
     progress_bar.output( true );
   }
 
+  if ( iteration_data_writer )
+  {
+    iteration_data_writer -> flush();
+  }
+
   // Deactivate the final actor after simulation is done in single_actor_batch
   if ( single_actor_batch )
   {
@@ -3186,27 +3297,36 @@ void sim_t::set_error(std::string error)
     fmt::print( stderr, "{}\n", error );
     std::fflush( stderr );
 
+    AUTO_LOCK( error_mutex );
     error_list.push_back( std::move( error ) );
 }
 
 /// merge sims
 void sim_t::merge( sim_t& other_sim )
 {
-  auto_lock_t auto_lock( merge_mutex );
-  const auto start_time = chrono::wall_clock::now();
-
   if ( scaling -> scale_stat == STAT_NONE &&
        scaling -> calculate_scale_factors == 0 &&
        plot -> dps_plot_stat_str.empty() &&
        reforge_plot -> reforge_plot_stat_str.empty() &&
-       profileset_map.empty() && ! profileset_enabled )
-  {
-    fmt::print( "Merging data from thread-{} ...\n", other_sim.thread_index );
+       profileset_map.empty() && ! profileset_enabled && ! parent )
+  {
+    // Only the main thread reports merges, thread children merge concurrently. The other sim may
+    // already hold the merged data of the threads below it in the merge tree.
+    int first = other_sim.thread_index;
+    int last  = std::min( first + ( first & -first ), threads ) - 1;
+    if ( last > first )
+      fmt::print( "Merging data from thread-{} to thread-{} ...\n", first, last );
+    else
+      fmt::print( "Merging data from thread-{} ...\n", first );
     std::fflush( stdout );
   }
 
   iterations += other_sim.iterations;
-  work_per_thread[ other_sim.thread_index ] = other_sim.work_done;
+  // Other sim may already hold the merged work of its own merge tree children
+  for ( size_t i = 0; i < work_per_thread.size() && i < other_sim.work_per_thread.size(); ++i )
+  {
+    work_per_thread[ i ] += other_sim.work_per_thread[ i ];
+  }
 
   simulation_length.merge( other_sim.simulation_length );
   total_dmg.merge( other_sim.total_dmg );
@@ -3217,9 +3337,15 @@ void sim_t::merge( sim_t& other_sim )
   raid_aps.merge( other_sim.raid_aps );
   event_mgr.merge( other_sim.event_mgr );
 
-  for ( auto & buff : buff_list )
+  // Sim buffs and actors are created in the same order in every thread, so the counterpart is
+  // normally found at the same position in the other sim. Fall back to lookups if not.
+  for ( size_t i = 0; i < buff_list.size(); ++i )
   {
-    if ( buff_t* otherbuff = buff_t::find( &other_sim, buff -> name_str ) )
+    buff_t* buff = buff_list[ i ];
+    buff_t* otherbuff = i < other_sim.buff_list.size() && other_sim.buff_list[ i ]->name_str == buff->name_str
+                            ? other_sim.buff_list[ i ]
+                            : buff_t::find( &other_sim, buff->name_str );
+    if ( otherbuff )
     {
       buff -> merge( *otherbuff );
     }
@@ -3233,7 +3359,10 @@ void sim_t::merge( sim_t& other_sim )
       continue;
     }
 
-    player_t* other_p = other_sim.find_player( player -> index );
+    auto idx = static_cast<size_t>( player->index );
+    player_t* other_p = idx < other_sim.actor_list.size() && other_sim.actor_list[ idx ]->index == player->index
+                            ? other_sim.actor_list[ idx ]
+                            : other_sim.find_player( player->index );
     assert( other_p );
     player -> merge( *other_p );
   }
@@ -3243,11 +3372,39 @@ void sim_t::merge( sim_t& other_sim )
   // After normal player merging, merge all dynamically spawned players. This is done after the
   // normal player merging because the dynamic spawner merging process may need to create new actors
   // into the parent (e.g., thread 0) sim to accommodate child sims managing to create more actors
-  // than the parent
+  // than the parent. With the merge tree this also runs on thread children; the placeholder actors
+  // are created into this sim, which has finished simulating and is not accessed by any other
+  // thread until its merge tree parent has joined it.
   spawner::merge( *this, other_sim );
 
   range::append( iteration_data, other_sim.iteration_data );
-  merge_time += chrono::elapsed(start_time);
+
+  simulation_end = std::max( simulation_end, other_sim.simulation_end );
+}
+
+/// merge a finished thread child into this sim
+void sim_t::merge_tree_child( sim_t* child )
+{
+  child -> join();
+
+  if ( child -> merge_ready )
+  {
+    merge( *child );
+    child -> merged = true;
+  }
+  // A child that failed to simulate did not merge its own merge tree children, do it here. A child
+  // that failed while merging them has canceled the simulation; the ones it already merged are not
+  // merged again.
+  else
+  {
+    for ( auto grandchild : child -> merge_children )
+    {
+      if ( ! grandchild -> merged )
+      {
+        merge_tree_child( grandchild );
+      }
+    }
+  }
 }
 
 /// merge all sims together
@@ -3258,7 +3415,19 @@ void sim_t::merge()
   if ( children.empty() )
     return;
 
-  merge_mutex.unlock();
+  simulation_end = chrono::wall_clock::now();
+
+  // Children merge their own merge tree children concurrently, so the main thread only merges
+  // log2( threads ) sims.
+  for ( auto child : merge_children )
+  {
+    merge_tree_child( child );
+  }
+  merge_children.clear();
+
+  // Merges overlap with the simulation of threads that have not finished yet, so merge time is the
+  // wall time from the last thread finishing its simulation to the end of the merge
+  merge_time = chrono::elapsed( simulation_end );
 
   for ( auto& child : children )
   {
@@ -3283,13 +3452,20 @@ void sim_t::run()
 {
   try
   {
-    if( iterate() )
+    merge_ready = iterate();
+    simulation_end = chrono::wall_clock::now();
+    if ( merge_ready )
     {
-      parent -> merge( *this );
+      work_per_thread[ thread_index ] = work_done;
+      for ( auto child : merge_children )
+      {
+        merge_tree_child( child );
+      }
     }
   }
   catch (const std::exception& e )
   {
+    merge_ready = false;
     if (parent)
       parent -> error("Error in child simulation ({}): {}", thread_index, e.what());
     cancel();
@@ -3301,6 +3477,7 @@ void sim_t::run()
 void sim_t::partition()
 {
   iterations = work_queue -> size();
+  iteration_total = iteration_offset + iterations;
 
   if ( threads <= 1 )
     return;
@@ -3309,8 +3486,6 @@ void sim_t::partition()
 
   thread::set_main_thread_priority();
 
-  merge_mutex.lock(); // parent sim is locked until parent merge() is called
-
   int remainder = iterations % threads;
   iterations /= threads;
 
@@ -3339,18 +3514,23 @@ void sim_t::partition()
   }
 
   for ( int i = 0; i < num_children; i++ )
-  {
-    auto  child = new sim_t( this, i + 1, child_control );
+    children.push_back( new sim_t( this, i + 1, child_control ) );
 
+  // With a fixed split of iterations, threads know the global index of their iterations
+  int next_offset = iteration_offset + iterations;
+  for ( auto child : children )
+  {
     assert( child );
-    children.push_back( child );
-
     child -> iterations = iterations;
     if ( remainder )
     {
       child -> iterations += 1;
       remainder--;
     }
+    child -> iteration_offset = next_offset;
+    child -> iteration_total = iteration_total;
+    next_offset += child -> iterations;
+    child -> iteration_data_file = iteration_data_file;
 
     if( deterministic || strict_work_queue )
     {
@@ -3358,11 +3538,19 @@ void sim_t::partition()
     }
     else // share the work queue
     {
-      child -> work_queue = work_queue;
+      child -> work_queue = work_queue -> share();
     }
     child -> report_progress = 0;
   }
 
+  // Pairwise merge tree: thread i merges into thread i with its lowest set bit cleared, so every
+  // sim merges the threads i + 1, i + 2, i + 4, ... below its own lowest set bit
+  for ( size_t i = 1; i < as<size_t>( threads ); ++i )
+  {
+    size_t tree_parent = i & ( i - 1 );
+    ( tree_parent == 0 ? this : children[ tree_parent - 1 ] ) -> merge_children.push_back( children[ i - 1 ] );
+  }
+
   computer_process::set_priority( process_priority ); // Set main thread priority
 
   for ( auto & child : children )
@@ -3402,10 +3590,7 @@ bool sim_t::execute()
 /// find player in sim by name
 player_t* sim_t::find_player( util::string_view name ) const
 {
-  auto it = range::find( actor_list, name, &player_t::name );
-  if ( it != actor_list.end())
-    return *it;
-  return nullptr;
+  return actor_name_index.find( name );
 }
 
 /// find player in sim by actor index
@@ -3421,13 +3606,13 @@ player_t* sim_t::find_player( int index ) const
 
 cooldown_t* sim_t::get_cooldown( util::string_view name )
 {
-  auto it = range::find( cooldown_list, name, &cooldown_t::name_str );
-  if ( it != cooldown_list.end() )
-    return *it;
+  if ( cooldown_t* c = cooldown_name_index.find( name ) )
+    return c;
 
   cooldown_t* c = new cooldown_t( name, *this );
 
   cooldown_list.push_back( c );
+  cooldown_name_index.add( c );
 
   return c;
 }
@@ -3742,6 +3927,7 @@ void sim_t::create_options()
 
   add_option( opt_bool( "strict_parsing", strict_parsing ) );
   add_option( opt_bool( "debug_each", debug_each ) );
+  add_option( opt_bool( "verify_reset", verify_reset ) );
   add_option( opt_func( "debug_seed", parse_debug_seed ) );
   add_option( opt_func( "json", parse_json_reports ) );
   add_option( opt_func( "json2", replace_json2 ) );
@@ -3750,6 +3936,8 @@ void sim_t::create_options()
   add_option( opt_int( "healing", healing ) );
   add_option( opt_bool( "log", log ) );
   add_option( opt_string( "output", output_file_str ) );
+  add_option( opt_string( "iteration_data_file", iteration_data_file_str ) );
+  add_option( opt_string( "iteration_data_buffs", iteration_data_buffs ) );
   add_option( opt_bool( "save_raid_summary", save_raid_summary ) );
   add_option( opt_bool( "save_gear_comments", save_gear_comments ) );
   add_option( opt_bool( "buff_uptime_timeline", buff_uptime_timeline ) );
@@ -3770,6 +3958,7 @@ void sim_t::create_options()
   add_option( opt_obsoleted( "rng" ) );
   add_option( opt_bool( "deterministic", deterministic ) );
   add_option( opt_bool( "strict_work_queue", strict_work_queue ) );
+  add_option( opt_bool( "common_random_numbers", common_random_numbers ) );
   add_option( opt_float( "report_iteration_data", report_iteration_data ) );
   add_option( opt_int( "min_report_iteration_data", min_report_iteration_data ) );
   add_option( opt_bool( "average_range", average_range ) );
@@ -3778,9 +3967,9 @@ void sim_t::create_options()
   add_option( opt_list( "party", party_encoding ) );
   add_option( opt_func( "active", parse_active ) );
   add_option( opt_uint64( "seed", seed ) );
-  add_option( opt_float( "wheel_granularity", event_mgr.wheel_granularity ) );
-  add_option( opt_int( "wheel_seconds", event_mgr.wheel_seconds ) );
-  add_option( opt_int( "wheel_shift", event_mgr.wheel_shift ) );
+  add_option( opt_obsoleted( "wheel_granularity" ) );
+  add_option( opt_obsoleted( "wheel_seconds" ) );
+  add_option( opt_obsoleted( "wheel_shift" ) );
   add_option( opt_string( "reference_player", reference_player_str ) );
   add_option( opt_string( "raid_events", raid_events_str ) );
   add_option( opt_append( "raid_events+", raid_events_str ) );
@@ -3874,6 +4063,7 @@ void sim_t::create_options()
   add_option( opt_bool( "report_raw_abilities", report_raw_abilities ) );
   add_option( opt_bool( "report_rng", report_rng ) );
   add_option( opt_int( "statistics_level", statistics_level ) );
+  add_option( opt_float( "statistics_sketch_accuracy", statistics_sketch_accuracy, 0.0, 0.5 ) );
   add_option( opt_bool( "separate_stats_by_actions", separate_stats_by_actions ) );
   add_option( opt_bool( "report_raid_summary", report_raid_summary ) ); // Force reporting of raid summary
   add_option( opt_string( "reforge_plot_output_file", reforge_plot_output_file_str ) );
@@ -4263,6 +4453,17 @@ void sim_t::setup( sim_control_t* c )
       throw std::runtime_error(fmt::format("Unable to open output file '{}'.", output_file_str));
     }
   }
+
+  // Thread children write to the iteration data file of the main thread (see partition())
+  if ( ! parent && ! iteration_data_file_str.empty() )
+  {
+    iteration_data_file = std::make_shared<iteration_data_file_t>( iteration_data_file_str );
+    if ( ! iteration_data_file -> is_open() )
+    {
+      throw std::runtime_error(fmt::format("Unable to open iteration data file '{}'.", iteration_data_file_str));
+    }
+  }
+
   if ( debug_each )
     debug = true;
 
@@ -4318,15 +4519,24 @@ void sim_t::setup( sim_control_t* c )
     work_queue -> batches( player_no_pet_list.size() );
   }
   work_queue -> init( iterations );
-  if ( thread_index == 0 )
-  {
-    work_per_thread.resize( threads );
-  }
+  work_per_thread.resize( threads );
 
   if( deterministic && ( target_error != 0 ) )
   {
     throw std::invalid_argument("deterministic=1 cannot be used with non-zero target_error values!");
   }
+
+  // Paired errors are computed from the per iteration samples, which sketched data does not keep
+  if ( common_random_numbers && statistics_sketch_accuracy > 0 )
+  {
+    throw std::invalid_argument("common_random_numbers=1 cannot be used with non-zero statistics_sketch_accuracy values!");
+  }
+
+  // Iterations are paired by thread, so each thread runs a fixed share of the work
+  if ( common_random_numbers )
+  {
+    strict_work_queue = true;
+  }
 }
 
 // sim_t::progress ==========================================================
@@ -4429,8 +4639,31 @@ void sim_t::abort()
 }
 
 /// add chart to sim for end of report processing
+sim_t::chart_capture_t::chart_capture_t( chart_data_t& data ) : previous( captured_chart_data )
+{
+  captured_chart_data = &data;
+}
+
+sim_t::chart_capture_t::~chart_capture_t()
+{
+  captured_chart_data = previous;
+}
+
 void sim_t::add_chart_data( const highchart::chart_t& chart )
 {
+  if ( captured_chart_data )
+  {
+    if ( chart.toggle_id_str_.empty() )
+    {
+      captured_chart_data->on_ready_chart_data.push_back( chart.to_aggregate_string( false ) );
+    }
+    else
+    {
+      captured_chart_data->chart_data.emplace_back( chart.toggle_id_str_, chart.to_data() );
+    }
+    return;
+  }
+
   if ( chart.toggle_id_str_.empty() )
   {
     on_ready_chart_data.push_back( chart.to_aggregate_string( false ) );
@@ -4441,6 +4674,15 @@ void sim_t::add_chart_data( const highchart::chart_t& chart )
   }
 }
 
+void sim_t::add_chart_data( const chart_data_t& data )
+{
+  range::append( on_ready_chart_data, data.on_ready_chart_data );
+  for ( const auto& entry : data.chart_data )
+  {
+    chart_data[ entry.first ].push_back( entry.second );
+  }
+}
+
 void sim_t::print_spell_query()
 {
   if ( ! spell_query_xml_output_file_str.empty() )
@@ -4513,16 +4755,25 @@ std::vector<double> sc_timeline_t::build_divisor_timeline( const extended_sample
  */
 void sc_timeline_t::adjust( sim_t& sim )
 {
-  // Check if we have divisor timeline cached
-  auto it = sim.divisor_timeline_cache.find( bin_size_ );
-  if ( it == sim.divisor_timeline_cache.end() )
+  const std::vector<double>* divisor_timeline;
+
   {
-    // If we don't have a cached divisor timeline, build one
-    sim.divisor_timeline_cache[ bin_size_ ] = build_divisor_timeline( sim.simulation_length, bin_size_ );
+    AUTO_LOCK( sim.analyze_mutex );
+
+    // Check if we have divisor timeline cached
+    auto it = sim.divisor_timeline_cache.find( bin_size_ );
+    if ( it == sim.divisor_timeline_cache.end() )
+    {
+      // If we don't have a cached divisor timeline, build one
+      it = sim.divisor_timeline_cache.emplace( bin_size_, build_divisor_timeline( sim.simulation_length, bin_size_ ) )
+               .first;
+    }
+
+    divisor_timeline = &it->second;
   }
 
   // Do the timeline adjustement
-  timeline_t::adjust( sim.divisor_timeline_cache[ bin_size_ ] );
+  timeline_t::adjust( *divisor_timeline );
 }
 
 void sc_timeline_t::adjust( const extended_sample_data_t& adjustor )
@@ -4537,14 +4788,14 @@ void sim_t::enable_debug_seed()
 {
   auto enabled = false;
 
-  if ( debug_seed.size() == 1 && seed == debug_seed[ 0 ] )
+  if ( debug_seed.size() == 1 && iteration_seed == debug_seed[ 0 ] )
   {
     enabled = true;
   }
   else
   {
-    auto it = range::lower_bound( debug_seed, seed );
-    enabled = it != debug_seed.end() && *it == seed;
+    auto it = range::lower_bound( debug_seed, iteration_seed );
+    enabled = it != debug_seed.end() && *it == iteration_seed;
   }
 
   if ( enabled )
@@ -4556,14 +4807,14 @@ void sim_t::enable_debug_seed()
     }
 
     std::shared_ptr<io::ofstream> o(new io::ofstream());
-    std::string fname = output_file_str + "." + util::to_string( seed );
+    std::string fname = output_file_str + "." + util::to_string( iteration_seed );
     o -> open( fname );
     if ( o -> is_open() )
     {
       out_debug = o;
       out_log = o;
 
-      fmt::print( "------ Iteration #{} (seed={}) ------", current_iteration, seed );
+      fmt::print( "------ Iteration #{} (seed={}) ------", current_iteration, iteration_seed );
       std::fflush( stdout );
     }
     else
@@ -12,6 +12,7 @@
 #include "sim_ostream.hpp"
 #include "sim/option.hpp"
 #include "util/concurrency.hpp"
+#include "util/name_index.hpp"
 #include "util/rng.hpp"
 #include "util/sample_data.hpp"
 #include "util/util.hpp"
@@ -30,6 +31,8 @@ namespace highchart {
     struct chart_t;
 }
 struct iteration_data_entry_t;
+class iteration_data_file_t;
+class iteration_data_writer_t;
 struct option_t;
 struct plot_t;
 struct raid_event_t;
@@ -89,6 +92,9 @@ struct sim_t : private sc_thread_t
   timespan_t max_time, expected_iteration_time;
   double vary_combat_length;
   int current_iteration, iterations;
+  // Incremented whenever the stack count of a buff changes, so that values derived from buff stacks
+  // can be cached (see parse_action_effects_t::get_effects_value)
+  uint64_t buff_stack_generation;
   double target_error;
   role_e target_error_role;
   double current_error;
@@ -131,12 +137,15 @@ struct sim_t : private sc_thread_t
   int         optimize_expressions_rounds;
   int         current_slot;
   int         optimal_raid, log, debug_each;
+  // Check the buffs, cooldowns and dots that are skipped in actor reset, as they have not changed state
+  bool        verify_reset;
   std::vector<uint64_t> debug_seed;
   stat_e      normalized_stat;
   std::string current_name, default_region_str, default_server_str, save_prefix_str, save_suffix_str;
   bool         save_talent_str;
   talent_format talent_input_format;
   auto_dispose< std::vector<player_t*> > actor_list;
+  name_index_t<player_t> actor_name_index;
   std::string main_target_str;
   int         stat_cache;
   int         max_aoe_enemies;
@@ -199,8 +208,22 @@ struct sim_t : private sc_thread_t
   // Random Number Generation
   rng::rng_t _rng;
   uint64_t seed;
+  // Reseed the sim and every actor stream at the start of each iteration (see seed_iteration()), and
+  // split iterations between threads in fixed blocks, so results do not depend on the thread count
   int deterministic;
   int strict_work_queue;
+  // Seed each iteration, and each actor in it, from the seed and the iteration, so sims that
+  // differ only in their actors (scale factor deltas, profilesets) can be compared iteration by
+  // iteration
+  bool common_random_numbers;
+  // Seed of the current iteration (deterministic or common random numbers), the global index of the
+  // first iteration of this thread, and the end of the global iteration range of all threads
+  uint64_t iteration_seed;
+  int iteration_offset, iteration_total;
+  // Stream numbers of the actors (by actor index) for seeding, from their names. Pet names include
+  // their owner, same-named actors are numbered in creation order.
+  rng::stream_id_map_t actor_stream_names;
+  std::vector<uint64_t> actor_stream_ids;
   int average_range, average_gauss;
 
   // Raid Events
@@ -542,12 +565,14 @@ struct sim_t : private sc_thread_t
 
   // Auras and De-Buffs
   auto_dispose<std::vector<buff_t*>> buff_list;
+  name_index_t<buff_t> buff_name_index;
 
   // Global aura related delay
   timespan_t default_aura_delay;
   timespan_t default_aura_delay_stddev;
 
   auto_dispose<std::vector<cooldown_t*>> cooldown_list;
+  name_index_t<cooldown_t> cooldown_name_index;
 
   /// Status of azerite-related effects
   azerite_control azerite_status;
@@ -588,10 +613,18 @@ struct sim_t : private sc_thread_t
   std::vector<player_t*> targets_by_name;
   std::vector<std::string> id_dictionary;
   std::map<double, std::vector<double> > divisor_timeline_cache;
+  // Guards the divisor timeline cache and the players_by_* lists, as actors are analyzed in parallel
+  mutex_t analyze_mutex;
   std::vector<report::json::report_configuration_t> json_reports;
   std::string output_file_str, html_file_str, json_file_str;
+  // Binary per-iteration output, shared by the threads of a sim, and the buffs whose uptimes it has
+  std::string iteration_data_file_str, iteration_data_buffs;
+  std::shared_ptr<iteration_data_file_t> iteration_data_file;
+  std::unique_ptr<iteration_data_writer_t> iteration_data_writer;
   std::string reforge_plot_output_file_str;
   std::vector<std::string> error_list;
+  // Reports are generated concurrently, and may add errors while others read them
+  mutable mutex_t error_mutex;
   int display_build;
   int report_precision;
   int report_pets_separately;
@@ -603,8 +636,11 @@ struct sim_t : private sc_thread_t
   int save_raid_summary;
   int save_gear_comments;
   int statistics_level;
+  double statistics_sketch_accuracy; // Relative accuracy of quantile sketches for collected data, 0 = exact
   int separate_stats_by_actions;
   int report_raid_summary;
+  // Per second buff (stack) uptime charts. Constant, overridden and quiet buffs are not reported, and
+  // collect no timeline.
   int buff_uptime_timeline;
   int buff_stack_uptime_timeline;
   bool json_full_states;
@@ -625,9 +661,16 @@ struct sim_t : private sc_thread_t
   bool merge_enemy_priority_dmg;
 
   // Multi-Threading
-  mutex_t merge_mutex;
   int threads;
   std::vector<sim_t*> children; // Manual delete!
+  // Thread children this sim merges before being merged itself (pairwise merge tree)
+  std::vector<sim_t*> merge_children;
+  // Sim simulated successfully and has results to merge
+  bool merge_ready;
+  // Sim has been merged into its merge tree parent
+  bool merged;
+  // When this sim, or the last thread merged into it, finished simulating
+  chrono::wall_clock::time_point simulation_end;
   int thread_index;
   computer_process::priority_e process_priority;
 
@@ -655,6 +698,25 @@ struct sim_t : private sc_thread_t
   // to correct elements (toggled elements in the HTML report) based on the data.
   std::map<std::string, std::vector<std::string> > chart_data;
 
+  // Chart data of a part of the HTML report, see chart_capture_t
+  struct chart_data_t
+  {
+    std::vector<std::string> on_ready_chart_data;
+    std::vector<std::pair<std::string, std::string>> chart_data;
+  };
+
+  // While in scope, charts added by the constructing thread are captured into the given chart data,
+  // instead of being added to the sim. Allows report sections to be generated in parallel, and their
+  // chart data to be added to the sim afterwards in report order.
+  class chart_capture_t
+  {
+    chart_data_t* previous;
+
+  public:
+    chart_capture_t( chart_data_t& data );
+    ~chart_capture_t();
+  };
+
   bool chart_show_relative_difference;
   // Use the max metric actor as the relative difference base instead of the min
   bool relative_difference_from_max;
@@ -678,6 +740,11 @@ struct sim_t : private sc_thread_t
   std::vector<std::string> profileset_output_data;
   bool profileset_enabled;
   int profileset_work_threads, profileset_init_threads;
+  // Racing: run profilesets in rounds starting at profileset_racing_iterations, dropping the ones
+  // that can no longer reach the top profileset_racing_top
+  int profileset_racing_top, profileset_racing_iterations;
+  // File that finished profileset results are appended to, and reused from by later runs
+  std::string profileset_cache;
   std::unique_ptr<profileset::profilesets_t> profilesets;
 
 
@@ -689,6 +756,8 @@ struct sim_t : private sc_thread_t
   void run() override;
   int       main( const std::vector<std::string>& args );
   double    iteration_time_adjust();
+  int       global_iteration() const;
+  bool      collect_iteration() const;
   double    expected_max_time() const;
   bool      is_canceled() const;
   void      cancel_iteration();
@@ -702,6 +771,7 @@ struct sim_t : private sc_thread_t
   void      datacollection_begin();
   void      datacollection_end();
   void      reset();
+  void      seed_iteration();
   void      check_actors();
   void      init_fight_style();
   void      init_parties();
@@ -712,6 +782,7 @@ struct sim_t : private sc_thread_t
   void      analyze();
   void      merge( sim_t& other_sim );
   void      merge();
+  void      merge_tree_child( sim_t* child );
   bool      iterate();
   void      partition();
   bool      execute();
@@ -757,6 +828,7 @@ struct sim_t : private sc_thread_t
   void combat_begin();
   void combat_end();
   void add_chart_data( const highchart::chart_t& chart );
+  void add_chart_data( const chart_data_t& data );
   bool has_raid_event( util::string_view type ) const;
 
   // Activates the necessary actor/actors before iteration begins.
@@ -0,0 +1,200 @@
+// ==========================================================================
+// Dedmonwakeen's Raid DPS/TPS Simulator.
+// Send questions to natehieter@gmail.com
+// ==========================================================================
+
+#include "work_queue.hpp"
+
+#include "sim/sim.hpp"
+
+// Standard progress method, normal mode sims use the single (first) index, single actor batch
+// sims progress with the main thread's current index.
+sim_progress_t work_queue_t::progress( int idx )
+{
+  size_t current_index = idx;
+  if ( idx < 0 )
+  {
+    current_index = index;
+  }
+
+  const auto& b = current_index < pool->batches.size() ? pool->batches[ current_index ] : pool->batches.back();
+
+  return sim_progress_t{ b.completed_work.load(), b.projected_work.load() };
+}
+
+#ifdef UNIT_TEST
+// Code to test correctness and thread scaling of the work queue
+
+#include <thread>
+
+#include "lib/fmt/format.h"
+#include "util/chrono.hpp"
+
+namespace
+{
+// The mutex based work queue used before chunked claims, for comparison
+struct locked_queue_t
+{
+  struct pool_t
+  {
+    std::mutex m;
+    int total_work = 0, work = 0;
+  };
+
+  std::shared_ptr<pool_t> pool = std::make_shared<pool_t>();
+  bool has_work                = true;
+
+  std::shared_ptr<locked_queue_t> share()
+  {
+    auto handle  = std::make_shared<locked_queue_t>();
+    handle->pool = pool;
+    return handle;
+  }
+
+  void init( int w )
+  { pool->total_work = w; }
+
+  size_t pop()
+  {
+    std::lock_guard<std::mutex> l( pool->m );
+    if ( pool->work < pool->total_work && ++pool->work < pool->total_work )
+      return 0;
+    has_work = false;
+    return 0;
+  }
+
+  bool more_work()
+  { return has_work; }
+};
+
+int failures = 0;
+
+void check( bool ok, const std::string& what )
+{
+  if ( !ok )
+  {
+    fmt::print( "FAILED: {}\n", what );
+    ++failures;
+  }
+}
+
+// Stand-in for the cost of an iteration
+void spin( unsigned amount )
+{
+  volatile unsigned x = 0;
+  for ( unsigned i = 0; i < amount; ++i )
+    x = x + i;
+}
+
+/* Run 'work' iterations on n_threads threads, the way sim_t::iterate() does: every thread runs an
+ * iteration, then pops to record it and to learn whether to continue. Returns the wall time.
+ */
+template <typename Queue>
+double run( unsigned n_threads, int work, unsigned cost, std::atomic<int>& finished )
+{
+  Queue main;
+  main.init( work );
+  std::vector<std::shared_ptr<Queue>> handles;
+  for ( unsigned i = 0; i < n_threads; ++i )
+    handles.push_back( main.share() );
+
+  auto start_time = chrono::wall_clock::now();
+
+  std::vector<std::thread> threads;
+  for ( unsigned i = 0; i < n_threads; ++i )
+  {
+    threads.emplace_back( [ &, i ] {
+      auto& queue = *handles[ i ];
+      do
+      {
+        spin( cost );
+        finished.fetch_add( 1 );
+        queue.pop();
+      } while ( queue.more_work() );
+    } );
+  }
+
+  for ( auto& t : threads )
+    t.join();
+
+  return chrono::to_fp_seconds( chrono::elapsed( start_time ) );
+}
+
+// Iteration counts, and progress never running ahead of finished iterations
+void test_progress( unsigned n_threads, int work )
+{
+  work_queue_t main;
+  main.init( work );
+  std::vector<std::shared_ptr<work_queue_t>> handles;
+  for ( unsigned i = 0; i < n_threads; ++i )
+    handles.push_back( main.share() );
+
+  std::atomic<int> finished( 0 );
+  std::atomic<unsigned> exited( 0 );
+
+  std::vector<std::thread> threads;
+  for ( unsigned i = 0; i < n_threads; ++i )
+  {
+    threads.emplace_back( [ &, i ] {
+      auto& queue = *handles[ i ];
+      do
+      {
+        spin( 200 );
+        finished.fetch_add( 1 );
+        queue.pop();
+      } while ( queue.more_work() );
+      exited.fetch_add( 1 );
+    } );
+  }
+
+  int samples = 0, ahead = 0;
+  while ( exited.load() < n_threads )
+  {
+    int progress = main.progress().current_iterations;
+    if ( progress > finished.load() )
+      ++ahead;
+    ++samples;
+    std::this_thread::yield();
+  }
+
+  for ( auto& t : threads )
+    t.join();
+
+  auto name = fmt::format( "threads={} work={}", n_threads, work );
+  check( ahead == 0, fmt::format( "{}: progress ahead of finished iterations in {} of {} samples", name, ahead, samples ) );
+  check( main.progress().current_iterations == work,
+         fmt::format( "{}: progress {} at the end", name, main.progress().current_iterations ) );
+  check( finished >= work && finished <= work + as<int>( n_threads ),
+         fmt::format( "{}: {} iterations run", name, finished.load() ) );
+}
+}  // namespace
+
+int main( int, char** )
+{
+  for ( unsigned n_threads : { 1U, 2U, 8U, 32U } )
+  {
+    for ( int work : { 1, 7, 100, 10000 } )
+      test_progress( n_threads, work );
+  }
+
+  fmt::print( "Work queue tests: {}\n\n", failures ? "FAILED" : "passed" );
+  fmt::print( "Hardware threads: {}\n", std::thread::hardware_concurrency() );
+
+  for ( unsigned cost : { 0U, 20000U } )
+  {
+    const int work = cost ? 20000 : 2000000;
+    fmt::print( "\n{} iterations of {} spin steps, wall seconds:\n", work, cost );
+    fmt::print( "{:>8} {:>14} {:>14}\n", "threads", "locked queue", "work queue" );
+    for ( unsigned n_threads : { 1U, 8U, 32U, 64U } )
+    {
+      std::atomic<int> finished_locked( 0 ), finished_chunked( 0 );
+      double locked  = run<locked_queue_t>( n_threads, work, cost, finished_locked );
+      double chunked = run<work_queue_t>( n_threads, work, cost, finished_chunked );
+      fmt::print( "{:>8} {:>14.3f} {:>14.3f}\n", n_threads, locked, chunked );
+    }
+  }
+
+  return failures ? 1 : 0;
+}
+
+#endif  // UNIT_TEST
@@ -5,84 +5,177 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
 #include <vector>
 #include <mutex>
 #include "util/generic.hpp"
 
 struct sim_progress_t;
 
+// Iteration work queue. Threads that share work hold their own work_queue_t handle (see share())
+// to a common pool of atomic per-batch counters. Each handle claims a chunk of iterations at a
+// time and consumes it locally, so the shared claim counter is only touched once per chunk. Chunks
+// shrink as the remaining work runs out, so threads finish at roughly the same time. Completed
+// iterations are published individually, so progress never counts claimed but unfinished work.
 struct work_queue_t
-  {
-    private:
+{
+private:
 #ifndef SC_NO_THREADING
-    std::recursive_mutex m;
-    using G = std::lock_guard<std::recursive_mutex>;
+  using M = std::recursive_mutex;
 #else
-    struct no_m {
-      void lock() {}
-      void unlock() {}
-    };
-    struct nop {
-      nop(no_m i) { (void)i; }
-    };
-    no_m m;
-    using G = nop;
+  struct M {
+    void lock() {}
+    void unlock() {}
+  };
 #endif
-    public:
-    std::vector<int> _total_work, _work, _projected_work;
-    size_t index;
 
-    work_queue_t() : index( 0 )
-    { _total_work.resize( 1 ); _work.resize( 1 ); _projected_work.resize( 1 ); }
+  // Upper bound of iterations claimed at a time
+  static constexpr int MAX_CHUNK_SIZE = 16;
+
+  // Work state of a single batch (an actor in single actor batch mode). Claimed work may overshoot
+  // total work, as chunks are claimed without checking the total first.
+  struct batch_t
+  {
+    std::atomic<int> total_work, claimed_work, completed_work, projected_work;
+
+    batch_t() : total_work( 0 ), claimed_work( 0 ), completed_work( 0 ), projected_work( 0 )
+    { }
+
+    batch_t( const batch_t& other ) :
+      total_work( other.total_work.load() ), claimed_work( other.claimed_work.load() ),
+      completed_work( other.completed_work.load() ), projected_work( other.projected_work.load() )
+    { }
+
+    int work() const
+    { return std::min( claimed_work.load(), total_work.load() ); }
+  };
+
+  struct pool_t
+  {
+    M m;
+    std::vector<batch_t> batches;
+    std::atomic<int> n_handles;
+
+    pool_t() : batches( 1 ), n_handles( 1 )
+    { }
+  };
+
+  std::shared_ptr<pool_t> pool;
 
-    void init( int w )    { G l(m); range::fill( _total_work, w ); range::fill( _projected_work, w ); }
-    // Single actor batch sim init methods. Batches is the number of active actors
-    void batches( size_t n ) { G l(m); _total_work.resize( n ); _work.resize( n ); _projected_work.resize( n ); }
+  // Per-handle state: active batch index and the locally claimed chunk [chunk_next, chunk_end)
+  size_t index;
+  int chunk_next, chunk_end;
+  bool has_work;
 
-    void flush()          { G l(m); _total_work[ index ] = _projected_work[ index ] = _work[ index ]; }
-    int  size()           { G l(m); return index < _total_work.size() ? _total_work[ index ] : _total_work.back(); }
-    bool more_work()      { G l(m); return index < _total_work.size() && _work[ index ] < _total_work[ index ]; }
-    void lock()           { m.lock(); }
-    void unlock()         { m.unlock(); }
+  batch_t& batch()
+  { return pool->batches[ index ]; }
 
-    void project( int w )
+  void release_chunk()
+  { chunk_next = chunk_end = 0; }
+
+  // Guided scheduling, split the remaining work into a few chunks per thread
+  int chunk_size( int remaining ) const
+  { return std::clamp( remaining / ( 4 * pool->n_handles.load() ), 1, MAX_CHUNK_SIZE ); }
+
+public:
+  work_queue_t() :
+    pool( std::make_shared<pool_t>() ), index( 0 ), chunk_next( 0 ), chunk_end( 0 ), has_work( true )
+  { }
+
+  // Create a new handle that draws work from the same pool as this one
+  std::shared_ptr<work_queue_t> share()
+  {
+    auto handle = std::make_shared<work_queue_t>();
+    handle->pool = pool;
+    pool->n_handles++;
+    return handle;
+  }
+
+  void init( int w )
+  {
+    for ( auto& b : pool->batches )
     {
-      G l(m);
-      _projected_work[ index ] = w;
-#ifdef NDEBUG
-      if ( w > _work[ index ] )
-      {
-      }
-#endif
+      b.total_work = w;
+      b.projected_work = w;
     }
+  }
 
-    // Single-actor batch pop, uses several indices of work (per active actor), each thread has it's
-    // own state on what index it is simulating
-    size_t pop()
+  // Single-actor batch sim init methods. Batches is the number of active actors
+  void batches( size_t n ) { pool->batches.resize( n ); }
+
+  // Stop the current batch after the iterations completed so far. Iterations in chunks claimed by
+  // other handles are only run if they precede that point.
+  void flush()
+  {
+    auto& b = batch();
+    b.total_work = b.projected_work = std::min( b.completed_work.load(), b.work() );
+  }
+
+  int  size()           { return index < pool->batches.size() ? batch().total_work.load() : pool->batches.back().total_work.load(); }
+  bool more_work()      { return has_work && index < pool->batches.size(); }
+  void lock()           { pool->m.lock(); }
+  void unlock()         { pool->m.unlock(); }
+
+  void project( int w ) { batch().projected_work = w; }
+
+  // Single-actor batch pop, uses several indices of work (per active actor), each handle has its
+  // own state on what index it is simulating. A handle runs its first iteration on a batch before
+  // claiming anything, so claiming the last iteration of a batch ends it.
+  size_t pop()
+  {
+    auto& b = batch();
+    int total = b.total_work.load( std::memory_order_relaxed );
+    int next = -1;
+
+    if ( chunk_next < chunk_end && chunk_next < total )
     {
-      G l(m);
+      next = chunk_next++;
+    }
+    else
+    {
+      release_chunk();
 
-      if ( _work[ index ] >= _total_work[ index ] )
+      if ( b.claimed_work.load( std::memory_order_relaxed ) < total )
       {
-        if ( index < _work.size() - 1 )
+        int n     = chunk_size( total - b.claimed_work.load( std::memory_order_relaxed ) );
+        int start = b.claimed_work.fetch_add( n );
+        if ( start < total )
         {
-          ++index;
+          next       = start;
+          chunk_next = start + 1;
+          chunk_end  = std::min( start + n, total );
         }
-        return index;
       }
+    }
 
-      if ( ++_work[ index ] == _total_work[ index ] )
+    if ( next >= 0 )
+    {
+      // The iteration that just finished took work item 'next'
+      b.completed_work.fetch_add( 1, std::memory_order_relaxed );
+      if ( next + 1 < total )
       {
-        _projected_work[ index ] = _work[ index ];
-        if ( index < _work.size() - 1 )
-        {
-          ++index;
-        }
+        has_work = true;
         return index;
       }
+    }
 
-      return index;
+    // Batch is exhausted, move on to the next one (if any)
+    release_chunk();
+    b.projected_work = b.work();
+    if ( index < pool->batches.size() - 1 )
+    {
+      ++index;
+      has_work = batch().claimed_work.load() < batch().total_work.load();
+    }
+    else
+    {
+      has_work = false;
     }
 
-    sim_progress_t progress( int idx = -1 );
-  };
\ No newline at end of file
+    return index;
+  }
+
+  sim_progress_t progress( int idx = -1 );
+};
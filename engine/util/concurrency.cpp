@@ -5,10 +5,13 @@
 
 #include "concurrency.hpp"
 
+#include <atomic>
 #include <chrono>
+#include <exception>
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <vector>
 #include <stdio.h>
 
 #if defined( SC_WINDOWS )
@@ -304,4 +307,59 @@ void set_main_thread_priority()
 #else
 #endif
 }
+
+void parallel_for( std::size_t n, unsigned n_threads, const std::function<void( std::size_t )>& fn )
+{
+#ifndef SC_NO_THREADING
+  if ( n_threads > n )
+    n_threads = static_cast<unsigned>( n );
+
+  if ( n_threads > 1 )
+  {
+    std::atomic<std::size_t> next_index( 0 );
+    std::exception_ptr first_exception;
+    std::mutex exception_mutex;
+
+    auto worker = [ & ]() {
+      for ( std::size_t i = next_index++; i < n; i = next_index++ )
+      {
+        try
+        {
+          fn( i );
+        }
+        catch ( ... )
+        {
+          std::lock_guard<std::mutex> lock( exception_mutex );
+          if ( !first_exception )
+            first_exception = std::current_exception();
+        }
+      }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve( n_threads - 1 );
+    for ( unsigned i = 1; i < n_threads; ++i )
+    {
+      workers.emplace_back( worker );
+    }
+    worker();
+    for ( auto& t : workers )
+    {
+      t.join();
+    }
+
+    if ( first_exception )
+      std::rethrow_exception( first_exception );
+
+    return;
+  }
+#else
+  (void)n_threads;
+#endif
+
+  for ( std::size_t i = 0; i < n; ++i )
+  {
+    fn( i );
+  }
+}
 }
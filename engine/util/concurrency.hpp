@@ -13,6 +13,8 @@
 
 #include "config.hpp"
 #include "util/generic.hpp"
+#include <cstddef>
+#include <functional>
 #include <memory>
 
 #ifndef SC_NO_THREADING
@@ -81,4 +83,8 @@ namespace thread
 {
   // Windows (10) needs to promote main thread to higher priority
   void set_main_thread_priority();
+
+  // Call fn( i ) for every i in [0, n) using up to n_threads threads, including the calling
+  // thread. Returns once all calls have finished, rethrowing the first exception thrown by fn.
+  void parallel_for( std::size_t n, unsigned n_threads, const std::function<void( std::size_t )>& fn );
 }
@@ -0,0 +1,48 @@
+// ==========================================================================
+// Dedmonwakeen's Raid DPS/TPS Simulator.
+// Send questions to natehieter@gmail.com
+// ==========================================================================
+
+#pragma once
+
+#include "config.hpp"
+#include "util/span.hpp"
+#include "util/string_view.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+/* Hash index from name to the objects of a name-keyed object list (buffs, cooldowns, gains, ...)
+ * Objects are added in list order, and lookups return them in that order, so find() returns the
+ * same object as a front to back search of the list would. Keys refer to the name_str of the
+ * indexed objects, which must not change (or be destroyed) while the index is in use.
+ */
+template <typename T>
+class name_index_t
+{
+  std::unordered_map<util::string_view, std::vector<T*>> index;
+
+public:
+  void add( T* obj )
+  { index[ obj->name_str ].push_back( obj ); }
+
+  // First object added with the given name
+  T* find( util::string_view name ) const
+  {
+    auto it = index.find( name );
+    return it != index.end() ? it->second.front() : nullptr;
+  }
+
+  // All objects added with the given name, in the order they were added
+  util::span<T* const> find_all( util::string_view name ) const
+  {
+    auto it = index.find( name );
+    if ( it == index.end() )
+      return {};
+
+    return it->second;
+  }
+
+  void clear()
+  { index.clear(); }
+};
@@ -60,6 +60,32 @@ constexpr uint64_t rotl( const uint64_t x, int k ) {
 
 } // anon namespace
 
+uint64_t stream_seed( uint64_t seed, uint64_t stream )
+{
+  split_mix64_t mix64;
+  mix64.seed( seed );
+  mix64.seed( mix64.next() ^ stream );
+  return mix64.next();
+}
+
+uint64_t stream_id( util::string_view name )
+{
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for ( unsigned char c : name )
+  {
+    hash = ( hash ^ c ) * 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+uint64_t stream_id_map_t::next( util::string_view name )
+{
+  uint64_t& n = _count[ std::string( name ) ];
+  uint64_t id = n == 0 ? stream_id( name ) : stream_seed( stream_id( name ), n );
+  ++n;
+  return id;
+}
+
 /**
  * @brief XORSHIFT-128 Random Number Generator
  *
@@ -118,6 +144,39 @@ void xoshiro256plus_t::seed( uint64_t start ) noexcept
   init_state_from_mix64(s, start);
 }
 
+void xoshiro256plus_t::jump() noexcept
+{
+  jump( { 0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa, 0x39abdc4529b1661c } );
+}
+
+void xoshiro256plus_t::long_jump() noexcept
+{
+  jump( { 0x76e15d3efefdcbbf, 0xc5004e441c522fb3, 0x77710069854ee241, 0x39109bb02acbe635 } );
+}
+
+// Advance the state by the jump polynomial, from the xoshiro256+ reference implementation
+void xoshiro256plus_t::jump( const std::array<uint64_t, 4>& polynomial ) noexcept
+{
+  std::array<uint64_t, 4> t {};
+
+  for ( uint64_t word : polynomial )
+  {
+    for ( int b = 0; b < 64; ++b )
+    {
+      if ( word & ( UINT64_C( 1 ) << b ) )
+      {
+        for ( size_t i = 0; i < t.size(); ++i )
+        {
+          t[ i ] ^= s[ i ];
+        }
+      }
+      next();
+    }
+  }
+
+  s = t;
+}
+
 const char* xoshiro256plus_t::name() const noexcept
 {
   return "xoshiro256+";
@@ -334,6 +393,7 @@ double stdnormal_inv( double p )
 
 #include <random>
 #include <tuple>
+#include <vector>
 
 #include "lib/fmt/format.h"
 #include "util/generic.hpp"
@@ -341,6 +401,90 @@ double stdnormal_inv( double p )
 
 using test_clock = chrono::cpu_clock;
 
+static int failures = 0;
+
+static void check( bool ok, const std::string& what )
+{
+  if ( !ok )
+  {
+    fmt::print( "FAILED: {}\n", what );
+    ++failures;
+  }
+}
+
+// Outputs of the xoshiro256+ reference implementation (prng.di.unimi.it), with the state seeded by
+// SplitMix64 from 12345, and of the reference FNV-1a 64 bit hash
+static void test_reference()
+{
+  struct
+  {
+    const char* name;
+    void ( *advance )( rng::xoshiro256plus_t& );
+    uint64_t expected[ 3 ];
+  } streams[] = {
+    { "seed", []( rng::xoshiro256plus_t& ) {}, { 0x4f2790d70610546a, 0xd2ae33f21d5120ec, 0xa28f6ee203d01e40 } },
+    { "jump", []( rng::xoshiro256plus_t& e ) { e.jump(); },
+      { 0xab0242414824bb95, 0xe7b3eca9e7023807, 0x5bbd8b771378634f } },
+    { "long_jump", []( rng::xoshiro256plus_t& e ) { e.long_jump(); },
+      { 0x6cee1a2471439c18, 0x16fb2eebdfe044fa, 0xe97ce88f54737b63 } },
+    { "jump+long_jump", []( rng::xoshiro256plus_t& e ) { e.jump(); e.long_jump(); },
+      { 0x2097d7189f2d89cd, 0, 0 } },
+  };
+
+  for ( const auto& stream : streams )
+  {
+    rng::xoshiro256plus_t engine;
+    engine.seed( 12345 );
+    stream.advance( engine );
+    for ( uint64_t expected : stream.expected )
+    {
+      if ( expected == 0 )
+        break;
+      uint64_t value = engine.next();
+      check( value == expected, fmt::format( "xoshiro256+ {}: {:#x}, expected {:#x}", stream.name, value, expected ) );
+    }
+  }
+
+  for ( const auto& hash : { std::make_pair( "", 0xcbf29ce484222325 ), std::make_pair( "a", 0xaf63dc4c8601ec8c ),
+                             std::make_pair( "foobar", 0x85944171f73967e8 ) } )
+  {
+    uint64_t value = rng::stream_id( hash.first );
+    check( value == hash.second,
+           fmt::format( "stream_id(\"{}\"): {:#x}, expected {:#x}", hash.first, value, hash.second ) );
+  }
+
+  fmt::print( "Reference tests: {}\n\n", failures ? "FAILED" : "passed" );
+}
+
+// Actors are seeded by name, same-named pets (of one or of different owners) must still get
+// distinct streams, in the same way on every run
+static void test_stream_id_map()
+{
+  const char* names[] = { "Alice", "Alice_wild_imp", "Alice_wild_imp", "Bob_wild_imp", "Alice_wild_imp",
+                          "Bob_wild_imp", "Fluffy_Pillow" };
+
+  rng::stream_id_map_t map, again;
+  std::vector<uint64_t> ids;
+  for ( const char* name : names )
+  {
+    uint64_t id = map.next( name );
+    check( id == again.next( name ), fmt::format( "stream_id_map_t: stream of {} differs between runs", name ) );
+    ids.push_back( id );
+  }
+
+  check( ids[ 0 ] == rng::stream_id( "Alice" ), "stream_id_map_t: first stream of a name is not stream_id( name )" );
+  for ( size_t i = 0; i < ids.size(); ++i )
+  {
+    for ( size_t j = i + 1; j < ids.size(); ++j )
+    {
+      check( ids[ i ] != ids[ j ],
+             fmt::format( "stream_id_map_t: {} #{} and {} #{} share a stream", names[ i ], i, names[ j ], j ) );
+    }
+  }
+
+  fmt::print( "Stream id tests: {}\n\n", failures ? "FAILED" : "passed" );
+}
+
 template <typename Engine>
 static void test_one( rng::basic_rng_t<Engine>& rng, uint64_t n )
 {
@@ -361,6 +505,27 @@ static void test_one( rng::basic_rng_t<Engine>& rng, uint64_t n )
               n, rng.name(), average, elapsed_cpu, static_cast<uint64_t>( n * 1000.0 / elapsed_cpu ) );
 }
 
+template <typename Engine>
+static void test_batch( rng::basic_rng_t<Engine>& rng, uint64_t n )
+{
+  auto start_time = test_clock::now();
+
+  std::array<double, 256> buffer;
+  double average = 0;
+  for ( uint64_t i = 0; i < n; i += buffer.size() )
+  {
+    rng.real( buffer.data(), buffer.size() );
+    for ( double d : buffer )
+      average += d;
+  }
+
+  average /= n;
+  auto elapsed_cpu = chrono::elapsed_fp_seconds(start_time);
+
+  fmt::print( "{} batched calls to rng::{}::real(), average = {:.8f}, time = {}s, numbers/sec = {}\n\n",
+              n, rng.name(), average, elapsed_cpu, static_cast<uint64_t>( n * 1000.0 / elapsed_cpu ) );
+}
+
 template <typename Engine>
 static void test_seed( rng::basic_rng_t<Engine>& rng, uint64_t n )
 {
@@ -443,11 +608,13 @@ void for_each(Tuple&& t, F&& f)
 
 int main( int /*argc*/, char** /*argv*/ )
 {
-  auto generators = std::make_tuple(
-    rng::basic_rng_t<rng::xoshiro256plus_t>{},
-    rng::basic_rng_t<rng::xorshift128_t>{},
-    rng::basic_rng_t<rng::xorshift1024_t>{}
-  );
+  test_reference();
+  test_stream_id_map();
+
+  // The generators are not copyable, so the tuple is default constructed in place
+  std::tuple<rng::basic_rng_t<rng::xoshiro256plus_t>,
+             rng::basic_rng_t<rng::xorshift128_t>,
+             rng::basic_rng_t<rng::xorshift1024_t>> generators;
 
   std::random_device rd;
   uint64_t seed  = uint64_t(rd()) | (uint64_t(rd()) << 32);
@@ -457,6 +624,8 @@ int main( int /*argc*/, char** /*argv*/ )
 
   for_each( generators, []( auto& g ) { test_one( g, 1'000'000'000 ); } );
 
+  for_each( generators, []( auto& g ) { test_batch( g, 1'000'000'000 ); } );
+
   for_each( generators, []( auto& g ) { monte_carlo( g, 1'000'000'000 ); } );
 
   for_each( generators, []( auto& g ) { test_seed( g, 10'000'000 ); } );
@@ -530,6 +699,8 @@ int main( int /*argc*/, char** /*argv*/ )
   fmt::print( "calls to rng::stdnormal_inv( double x )\n" );
   fmt::print( "x=0.975: {:.7} should be equal to 1.959964\n", rng::stdnormal_inv( 0.975 ) );
   fmt::print( "x=0.995: {:.8} should be equal to 2.5758293\n", rng::stdnormal_inv( 0.995 ) );
+
+  return failures ? 1 : 0;
 }
 
 #endif // UNIT_TEST
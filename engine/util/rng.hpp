@@ -10,15 +10,20 @@
 
 #include "config.hpp"
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <iterator>
+#include <string>
+#include <unordered_map>
 #ifdef RNG_STREAM_DEBUG
 #include <iostream>
 #endif
 
+#include "util/string_view.hpp"
 #include "util/timespan.hpp"
 
 /** \ingroup SC_RNG
@@ -29,6 +34,22 @@ namespace rng {
 double stdnormal_cdf( double u );
 double stdnormal_inv( double u );
 
+/// Seed for an independent stream derived from a seed, e.g. per iteration or per actor
+uint64_t stream_seed( uint64_t seed, uint64_t stream );
+
+/// Stream number for a name ( 64-bit FNV-1a ), identical across platforms, compilers and runs
+uint64_t stream_id( util::string_view name );
+
+/// Stream numbers for streams that may share a name (e.g., several pets of one kind and owner). The
+/// first stream of a name gets stream_id( name ), later ones are told apart by their order.
+class stream_id_map_t
+{
+  std::unordered_map<std::string, uint64_t> _count;
+
+public:
+  uint64_t next( util::string_view name );
+};
+
 /**\ingroup SC_RNG
  * @brief Random number generator wrapper around an rng engine
  *
@@ -59,9 +80,24 @@ public:
   /// Reset any state
   void reset();
 
+  /// Advance the stream as if by 2^128 draws, to split it into non-overlapping substreams
+  void jump() {
+    engine.jump();
+    reset();
+  }
+
+  /// Advance the stream as if by 2^192 draws, to split it into non-overlapping sets of substreams
+  void long_jump() {
+    engine.long_jump();
+    reset();
+  }
+
   /// Uniform distribution in range [0..1)
   double real();
 
+  /// Fill a buffer with uniform values in range [0..1), the same values n calls to real() return
+  void real( double* out, size_t size );
+
   /// Bernoulli Distribution
   bool roll( double chance );
 
@@ -197,6 +233,43 @@ inline double basic_rng_t<Engine>::real()
   return u.d - 1.0;
 }
 
+/// Fill a buffer with uniform values in range [0..1). Draws and float conversion are done in
+/// separate passes over a chunk, so the conversion vectorizes.
+template <typename Engine>
+void basic_rng_t<Engine>::real( double* out, size_t size )
+{
+  constexpr size_t chunk_size = 64;
+  uint64_t bits[ chunk_size ];
+
+  while ( size > 0 )
+  {
+    size_t count = std::min( size, chunk_size );
+    for ( size_t i = 0; i < count; ++i )
+    {
+      bits[ i ] = engine.next();
+    }
+
+    for ( size_t i = 0; i < count; ++i )
+    {
+      bits[ i ] = ( bits[ i ] & 0x000fffffffffffff ) | 0x3ff0000000000000;
+    }
+
+    std::memcpy( out, bits, count * sizeof( double ) );
+    for ( size_t i = 0; i < count; ++i )
+    {
+      out[ i ] -= 1.0;
+    }
+
+#ifdef RNG_STREAM_DEBUG
+    n += count;
+    std::cout << fmt::format( "[RNG] fn=real(n) engine={} n={} count={}",
+                             engine.name(), n, count ) << std::endl;
+#endif
+    out += count;
+    size -= count;
+  }
+}
+
 /// Bernoulli Distribution
 template <typename Engine>
 bool basic_rng_t<Engine>::roll( double chance )
@@ -402,8 +475,12 @@ struct xoshiro256plus_t
 {
   uint64_t next() noexcept;
   void seed( uint64_t start ) noexcept;
+  void jump() noexcept;
+  void long_jump() noexcept;
   const char* name() const noexcept;
 private:
+  void jump( const std::array<uint64_t, 4>& polynomial ) noexcept;
+
   std::array<uint64_t, 4> s;
 };
 
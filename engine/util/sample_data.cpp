@@ -0,0 +1,213 @@
+// ==========================================================================
+// Dedmonwakeen's Raid DPS/TPS Simulator.
+// Send questions to natehieter@gmail.com
+// ==========================================================================
+
+#ifdef UNIT_TEST
+// Code to test sketched sample data against exact sample data
+
+#include "sample_data.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <random>
+
+#include "lib/fmt/format.h"
+
+namespace
+{
+const double ACCURACY = 0.005;
+
+int failures = 0;
+
+void check( bool ok, const std::string& what )
+{
+  if ( !ok )
+  {
+    fmt::print( "FAILED: {}\n", what );
+    ++failures;
+  }
+}
+
+bool close( double a, double b, double tolerance )
+{ return std::fabs( a - b ) <= tolerance * std::max( 1.0, std::max( std::fabs( a ), std::fabs( b ) ) ); }
+
+using generator_t = double ( * )( std::mt19937_64& );
+
+double normal( std::mt19937_64& rng )
+{ return std::normal_distribution<double>( 100000.0, 15000.0 )( rng ); }
+
+double exponential( std::mt19937_64& rng )
+{ return std::exponential_distribution<double>( 1e-4 )( rng ); }
+
+// Both signs and exact zeros, like a net healing minus damage taken metric
+double mixed_sign( std::mt19937_64& rng )
+{
+  if ( rng() % 16 == 0 )
+    return 0;
+  return std::normal_distribution<double>( 0.0, 1000.0 )( rng );
+}
+
+// Spread over twelve orders of magnitude
+double wide_range( std::mt19937_64& rng )
+{ return std::pow( 10.0, std::uniform_real_distribution<double>( -3.0, 9.0 )( rng ) ); }
+
+struct distribution_t
+{
+  const char* name;
+  generator_t generate;
+};
+
+const distribution_t distributions[] = {
+  { "normal", normal },
+  { "exponential", exponential },
+  { "mixed_sign", mixed_sign },
+  { "wide_range", wide_range },
+};
+
+extended_sample_data_t make_data( bool sketched )
+{
+  extended_sample_data_t data( sketched ? "sketch" : "exact", false );
+  if ( sketched )
+    data.enable_sketch( ACCURACY );
+  return data;
+}
+
+// Every percentile of the sketch must be within ACCURACY * |x| of the exact sample x of the same rank
+void compare_percentiles( const extended_sample_data_t& exact, const extended_sample_data_t& sketch,
+                          const std::string& name )
+{
+  int outside  = 0;
+  double worst = 0;
+  for ( int i = 0; i <= 1000; ++i )
+  {
+    double x     = exact.percentile( i / 1000.0 );
+    double error = std::fabs( sketch.percentile( i / 1000.0 ) - x );
+    // Magnitudes below MIN_VALUE are counted as zero
+    if ( error > ACCURACY * std::fabs( x ) * ( 1 + 1e-9 ) + statistics::quantile_sketch_t::MIN_VALUE )
+      ++outside;
+    if ( x != 0 )
+      worst = std::max( worst, error / std::fabs( x ) );
+  }
+
+  check( outside == 0,
+         fmt::format( "{}: {} percentiles outside the relative accuracy, worst {:.5f}", name, outside, worst ) );
+  fmt::print( "{:>12}: worst relative percentile error {:.5f}\n", name, worst );
+}
+
+// Count, min and max are exact in sketch mode, mean and variance up to summation order
+void compare_moments( const extended_sample_data_t& exact, const extended_sample_data_t& sketch,
+                      const std::string& name )
+{
+  check( exact.count() == sketch.count(), name + ": count" );
+  check( exact.min() == sketch.min(), name + ": min" );
+  check( exact.max() == sketch.max(), name + ": max" );
+  check( close( exact.mean(), sketch.mean(), 1e-9 ), fmt::format( "{}: mean {} != {}", name, sketch.mean(), exact.mean() ) );
+  check( close( exact.variance, sketch.variance, 1e-6 ),
+         fmt::format( "{}: variance {} != {}", name, sketch.variance, exact.variance ) );
+}
+
+void test_accuracy( const distribution_t& d, size_t n, uint64_t seed )
+{
+  std::mt19937_64 rng( seed );
+  auto exact  = make_data( false );
+  auto sketch = make_data( true );
+  for ( size_t i = 0; i < n; ++i )
+  {
+    double x = d.generate( rng );
+    exact.add( x );
+    sketch.add( x );
+  }
+  exact.analyze();
+  sketch.analyze();
+
+  auto name = fmt::format( "{} n={}", d.name, n );
+  check( sketch.sketched() && !exact.sketched(), name + ": modes" );
+  compare_moments( exact, sketch, name );
+  compare_percentiles( exact, sketch, name );
+
+  // Bucket counts are approximate, but the histograms must cover the same samples
+  auto total = []( const std::vector<size_t>& h ) { return std::accumulate( h.begin(), h.end(), size_t() ); };
+  check( sketch.distribution.size() == exact.distribution.size() &&
+         total( sketch.distribution ) == total( exact.distribution ),
+         fmt::format( "{}: histogram holds {} samples, expected {}", name, total( sketch.distribution ),
+                      total( exact.distribution ) ) );
+}
+
+// Per thread results merged in different orders must equal the sketch of all samples
+void test_merge( const distribution_t& d, size_t parts, size_t n_per_part, uint64_t seed )
+{
+  std::mt19937_64 rng( seed );
+  auto exact = make_data( false );
+  auto whole = make_data( true );
+  std::vector<extended_sample_data_t> part;
+  for ( size_t p = 0; p < parts; ++p )
+  {
+    part.push_back( make_data( true ) );
+    for ( size_t i = 0; i < n_per_part * ( p + 1 ); ++i )
+    {
+      double x = d.generate( rng );
+      exact.add( x );
+      whole.add( x );
+      part.back().add( x );
+    }
+  }
+
+  auto forward = make_data( true );
+  for ( const auto& p : part )
+    forward.merge( p );
+
+  auto backward = make_data( true );
+  for ( size_t p = parts; p-- > 0; )
+    backward.merge( part[ p ] );
+
+  // Pairwise, like the thread merge tree of sim_t
+  auto tree = part;
+  for ( size_t stride = 1; stride < parts; stride *= 2 )
+  {
+    for ( size_t p = 0; p + stride < parts; p += 2 * stride )
+      tree[ p ].merge( tree[ p + stride ] );
+  }
+
+  exact.analyze();
+  whole.analyze();
+  forward.analyze();
+  backward.analyze();
+  tree[ 0 ].analyze();
+
+  auto name = fmt::format( "{} merge", d.name );
+  for ( const auto* merged : { &forward, &backward, &tree[ 0 ] } )
+  {
+    compare_moments( exact, *merged, name );
+    for ( int i = 0; i <= 1000; ++i )
+    {
+      if ( merged->percentile( i / 1000.0 ) != whole.percentile( i / 1000.0 ) )
+      {
+        check( false, fmt::format( "{}: percentile {} differs from the unmerged sketch", name, i / 1000.0 ) );
+        break;
+      }
+    }
+    check( merged->distribution == whole.distribution, name + ": histogram differs from the unmerged sketch" );
+  }
+  compare_percentiles( exact, tree[ 0 ], name );
+}
+}  // namespace
+
+int main( int argc, char** argv )
+{
+  uint64_t seed = argc > 1 ? std::strtoull( argv[ 1 ], nullptr, 10 ) : 12345;
+  fmt::print( "Seed: {}, relative accuracy: {}\n\n", seed, ACCURACY );
+
+  for ( const auto& d : distributions )
+  {
+    for ( size_t n : { 1, 2, 10, 1000, 100000 } )
+      test_accuracy( d, n, seed + n );
+    test_merge( d, 7, 5000, seed );
+  }
+
+  fmt::print( "\nSample data tests: {}\n", failures ? "FAILED" : "passed" );
+
+  return failures ? 1 : 0;
+}
+
+#endif  // UNIT_TEST
@@ -8,6 +8,7 @@
 
 #include <limits>
 #include <numeric>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -106,6 +107,37 @@ range::value_type_t<Range> calculate_mean_stddev( const Range& r )
   return calculate_mean_stddev( r, calculate_mean( r ) );
 }
 
+/* Standard Deviation of the mean difference of two equally long samples, paired
+ * element by element
+ */
+template <typename Range>
+range::value_type_t<Range> calculate_paired_mean_stddev( const Range& a,
+                                                         const Range& b )
+{
+  assert( std::size( a ) == std::size( b ) );
+
+  auto length = std::size( a );
+  if ( length == 0 )
+    return {};
+
+  range::value_type_t<Range> mean{};
+  for ( size_t i = 0; i < length; ++i )
+    mean += a[ i ] - b[ i ];
+  mean /= length;
+
+  range::value_type_t<Range> variance{};
+  for ( size_t i = 0; i < length; ++i )
+  {
+    auto delta = a[ i ] - b[ i ] - mean;
+    variance += delta * delta;
+  }
+  variance /= length;
+
+  if ( length > 1 )
+    variance /= length;
+  return std::sqrt( variance );
+}
+
 template <typename Range>
 std::vector<size_t> create_histogram( const Range& r, size_t num_buckets,
                                       range::value_type_t<Range> min,
@@ -188,6 +220,168 @@ inline std::vector<double> normalize_histogram( const std::vector<size_t>& in )
   return normalize_histogram( in, count );
 }
 
+
+/* Mergeable quantile sketch with a relative error guarantee ( DDSketch, Masson et al. 2019 ).
+ *
+ * Samples are counted in logarithmically sized buckets, bucket i covering ( g^(i-1), g^i ] with
+ * g = ( 1 + a ) / ( 1 - a ) for relative accuracy a. Every quantile is answered with a value within
+ * a * |x| of the exact sample x of the same rank. The guarantee holds as long as the samples of
+ * one sign span less than g^MAX_BUCKETS (about 1e17 at a = 0.5%), beyond which the smallest
+ * magnitudes are folded together. Samples with |x| < MIN_VALUE are counted as zero.
+ *
+ * Memory is bounded by MAX_BUCKETS counters per sign, independent of the number of samples.
+ * Merging adds up bucket counts, so the result does not depend on the merge order.
+ */
+class quantile_sketch_t
+{
+public:
+  static constexpr int MAX_BUCKETS = 4096;
+  static constexpr double MIN_VALUE = 1e-9;
+
+private:
+  // Dense bucket counts of one sign, counts[ j ] holds bucket offset + j
+  struct store_t
+  {
+    std::vector<size_t> counts;
+    int offset = 0;
+
+    void add( int index, size_t n )
+    {
+      if ( counts.empty() )
+      {
+        offset = index;
+        counts.assign( 1, 0 );
+      }
+      else if ( index < offset )
+      {
+        // Never grow below the lowest bucket the limit allows, fold into it instead
+        int lowest = std::max( index, offset + static_cast<int>( counts.size() ) - MAX_BUCKETS );
+        counts.insert( counts.begin(), static_cast<size_t>( offset - lowest ), 0 );
+        offset = lowest;
+        index  = lowest;
+      }
+      else if ( index - offset >= static_cast<int>( counts.size() ) )
+      {
+        counts.resize( static_cast<size_t>( index - offset + 1 ), 0 );
+        if ( counts.size() > static_cast<size_t>( MAX_BUCKETS ) )
+        {
+          auto excess = counts.size() - MAX_BUCKETS;
+          auto folded = std::accumulate( counts.begin(), counts.begin() + excess + 1, size_t() );
+          counts.erase( counts.begin(), counts.begin() + excess );
+          counts.front() = folded;
+          offset += static_cast<int>( excess );
+        }
+      }
+
+      counts[ index - offset ] += n;
+    }
+
+    void merge( const store_t& other )
+    {
+      for ( size_t j = 0; j < other.counts.size(); ++j )
+      {
+        if ( other.counts[ j ] )
+          add( other.offset + static_cast<int>( j ), other.counts[ j ] );
+      }
+    }
+  };
+
+  double gamma, log_gamma;
+  store_t positive, negative;
+  size_t zero_count;
+
+  int index( double magnitude ) const
+  {
+    return static_cast<int>( std::ceil( std::log( magnitude ) / log_gamma ) );
+  }
+
+  // Bucket midpoint in the relative sense, at most a * x away from any x in the bucket
+  double value( int index ) const
+  {
+    return 2.0 * std::exp( index * log_gamma ) / ( gamma + 1.0 );
+  }
+
+public:
+  explicit quantile_sketch_t( double relative_accuracy ) :
+    gamma( ( 1.0 + relative_accuracy ) / ( 1.0 - relative_accuracy ) ),
+    log_gamma( std::log( gamma ) ),
+    zero_count( 0 )
+  {
+    assert( relative_accuracy > 0 && relative_accuracy < 1 );
+  }
+
+  double relative_accuracy() const
+  {
+    return ( gamma - 1.0 ) / ( gamma + 1.0 );
+  }
+
+  void add( double x )
+  {
+    if ( x > MIN_VALUE )
+      positive.add( index( x ), 1 );
+    else if ( x < -MIN_VALUE )
+      negative.add( index( -x ), 1 );
+    else
+      ++zero_count;
+  }
+
+  void merge( const quantile_sketch_t& other )
+  {
+    assert( gamma == other.gamma );
+
+    positive.merge( other.positive );
+    negative.merge( other.negative );
+    zero_count += other.zero_count;
+  }
+
+  void clear()
+  {
+    positive = store_t();
+    negative = store_t();
+    zero_count = 0;
+  }
+
+  /* Call f( value, count ) for every non-empty bucket in ascending order of value.
+   */
+  template <typename F>
+  void for_each_bucket( F&& f ) const
+  {
+    for ( size_t j = negative.counts.size(); j-- > 0; )
+    {
+      if ( negative.counts[ j ] )
+        f( -value( negative.offset + static_cast<int>( j ) ), negative.counts[ j ] );
+    }
+
+    if ( zero_count )
+      f( 0.0, zero_count );
+
+    for ( size_t j = 0; j < positive.counts.size(); ++j )
+    {
+      if ( positive.counts[ j ] )
+        f( value( positive.offset + static_cast<int>( j ) ), positive.counts[ j ] );
+    }
+  }
+
+  /* Value of the sample with the given (0-based) rank in ascending order
+   */
+  double rank_value( size_t rank ) const
+  {
+    double result = 0;
+    size_t seen = 0;
+    bool found = false;
+    for_each_bucket( [ & ]( double v, size_t n ) {
+      if ( !found && rank < seen + n )
+      {
+        result = v;
+        found  = true;
+      }
+      seen += n;
+    } );
+
+    return result;
+  }
+};
+
 }  // end sd namespace
 
 /* Simplest Samplest Data container. Only tracks sum and count
@@ -307,6 +501,10 @@ public:
 /* Extensive sample_data container with two runtime dependent modes:
  * - simple: Only offers sum, count
  *  -!simple: saves data and offers variance, percentiles, distribution, etc.
+ *
+ * The !simple mode can optionally use a quantile sketch (see enable_sketch()) instead of saving
+ * every sample. Count, sum, mean, min, max and variance stay exact, while percentiles and the
+ * distribution are approximated. data() and sorted_data() are empty in that case.
  */
 class extended_sample_data_t : public simple_sample_data_with_min_max_t
 {
@@ -326,6 +524,10 @@ private:
                                       // to do regression on it )
   bool is_sorted;
 
+  // Sketch mode: running mean and sum of squared deviations ( Welford ) of the samples
+  std::optional<statistics::quantile_sketch_t> sketch;
+  value_t _running_mean, _m2;
+
 public:
   explicit extended_sample_data_t( util::string_view n, bool s = true )
     : base_t(),
@@ -336,7 +538,9 @@ public:
       mean_variance(),
       mean_std_dev(),
       simple( s ),
-      is_sorted( false )
+      is_sorted( false ),
+      _running_mean(),
+      _m2()
   {
   }
 
@@ -347,6 +551,21 @@ public:
     clear();
   }
 
+  /* Use a quantile sketch with the given relative accuracy instead of saving all samples, when
+   * not in simple mode. Clears the collected data.
+   */
+  void enable_sketch( double relative_accuracy )
+  {
+    sketch.emplace( relative_accuracy );
+
+    clear();
+  }
+
+  bool sketched() const
+  {
+    return !simple && sketch;
+  }
+
   const std::string& name() const
   {
     return name_str;
@@ -355,7 +574,7 @@ public:
   // Reserve memory
   void reserve( std::size_t capacity )
   {
-    if ( !simple )
+    if ( !simple && !sketch )
       _data.reserve( capacity );
   }
 
@@ -366,6 +585,14 @@ public:
     {
       base_t::add( x );
     }
+    else if ( sketch )
+    {
+      base_t::add( x );
+      auto delta = x - _running_mean;
+      _running_mean += delta / base_t::count();
+      _m2 += delta * ( x - _running_mean );
+      sketch->add( x );
+    }
     else
     {
       _data.push_back( x );
@@ -380,7 +607,7 @@ public:
 
   size_t size() const
   {
-    if ( simple )
+    if ( simple || sketch )
       return base_t::count();
 
     return _data.size();
@@ -405,6 +632,12 @@ public:
     if ( simple )
       return;
 
+    if ( sketch )
+    {  // Min/max and sum are tracked exactly while adding
+      _mean = base_t::pretty_mean();
+      return;
+    }
+
     if ( data().empty() )
       return;
 
@@ -434,7 +667,7 @@ public:
   }
   size_t count() const
   {
-    return simple ? base_t::count() : data().size();
+    return simple || sketch ? base_t::count() : data().size();
   }
 
   /* Analyze Variance: Variance, Stddev and Stddev of the mean
@@ -445,16 +678,16 @@ public:
     if ( simple )
       return;
 
-    if ( _data.empty() )
+    if ( count() == 0 )
       return;
 
-    variance = statistics::calculate_variance( data(), mean() );
+    variance = sketch ? _m2 / count() : statistics::calculate_variance( data(), mean() );
     std_dev  = std::sqrt( variance );
 
     // Calculate Standard Deviation of the Mean ( Central Limit Theorem )
-    if ( data().size() > 1 )
+    if ( count() > 1 )
     {
-      mean_variance = variance / data().size();
+      mean_variance = variance / count();
       mean_std_dev  = std::sqrt( mean_variance );
     }
   }
@@ -471,6 +704,12 @@ public:
     {
       return;
     }
+    // Sketch buckets are always ordered
+    if ( sketch )
+    {
+      is_sorted = true;
+      return;
+    }
     _sorted_data = _data;
     range::sort( _sorted_data );
     is_sorted = true;
@@ -485,11 +724,61 @@ public:
     if ( simple )
       return;
 
-    if ( data().empty() )
+    if ( count() == 0 )
       return;
 
-    distribution = statistics::create_histogram( data(), num_buckets,
-                                                 base_t::min(), base_t::max() );
+    distribution = histogram( num_buckets, base_t::min(), base_t::max() );
+  }
+
+  /* Histogram ( not normalized ) of the data between min and max. In sketch mode, the samples of
+   * a sketch bucket are spread evenly over its value range, so histogram counts are approximate.
+   */
+  std::vector<size_t> histogram( size_t num_buckets, value_t min, value_t max ) const
+  {
+    if ( !sketched() )
+      return statistics::create_histogram( data(), num_buckets, min, max );
+
+    std::vector<size_t> result;
+    if ( count() == 0 || std::isnan( min ) || std::isnan( max ) || max <= min )
+      return result;
+
+    auto a     = sketch->relative_accuracy();
+    auto width = ( max - min ) / num_buckets;
+    std::vector<double> weights( num_buckets, 0.0 );
+    auto bucket_of = [ & ]( value_t v ) {
+      return std::min( static_cast<size_t>( ( v - min ) / width ), num_buckets - 1 );
+    };
+
+    sketch->for_each_bucket( [ & ]( value_t v, size_t n ) {
+      // Sketch bucket with value v covers [ v / ( 1 + a ), v / ( 1 - a ) ] ( mirrored if negative )
+      auto lo = std::clamp( v > 0 ? v / ( 1 + a ) : v / ( 1 - a ), min, max );
+      auto hi = std::clamp( v > 0 ? v / ( 1 - a ) : v / ( 1 + a ), min, max );
+      if ( hi <= lo )
+      {
+        weights[ bucket_of( lo ) ] += n;
+        return;
+      }
+
+      for ( auto i = bucket_of( lo ), last = bucket_of( hi ); i <= last; ++i )
+      {
+        auto overlap = std::min( hi, min + ( i + 1 ) * width ) - std::max( lo, min + i * width );
+        weights[ i ] += n * std::max( overlap, 0.0 ) / ( hi - lo );
+      }
+    } );
+
+    // Round cumulative weights so the counts add up to the sample count
+    result.assign( num_buckets, size_t{} );
+    double cumulative = 0;
+    size_t assigned   = 0;
+    for ( size_t i = 0; i < num_buckets; ++i )
+    {
+      cumulative += weights[ i ];
+      auto target = i + 1 < num_buckets ? static_cast<size_t>( std::llround( cumulative ) ) : count();
+      result[ i ] = target > assigned ? target - assigned : 0;
+      assigned += result[ i ];
+    }
+
+    return result;
   }
 
   void clear()
@@ -498,6 +787,9 @@ public:
     _sorted_data.clear();
     _data.clear();
     distribution.clear();
+    if ( sketch )
+      sketch->clear();
+    _running_mean = _m2 = 0;
   }
 
   // Access functions
@@ -510,12 +802,17 @@ public:
     if ( simple )
       return 0;
 
-    if ( data().empty() )
+    if ( count() == 0 )
       return 0;
 
     if ( !is_sorted )
       return base_t::nan();
 
+    // Bucket values may lie slightly outside the observed range
+    if ( sketch )
+      return std::clamp( sketch->rank_value( static_cast<size_t>( x * ( count() - 1 ) ) ), base_t::min(),
+                         base_t::max() );
+
     // Should be improved to use linear interpolation
     return ( sorted_data()[ (int)( x * ( sorted_data().size() - 1 ) ) ] );
   }
@@ -533,10 +830,26 @@ public:
   {
     assert( simple == other.simple );
 
+    assert( sketched() == other.sketched() );
+
     if ( simple )
     {
       base_t::merge( other );
     }
+    else if ( sketch )
+    {
+      // Combine running moments ( Chan et al. )
+      auto n_a = static_cast<value_t>( base_t::count() );
+      auto n_b = static_cast<value_t>( other.count() );
+      if ( n_b > 0 )
+      {
+        auto delta    = other._running_mean - _running_mean;
+        _running_mean = ( n_a * _running_mean + n_b * other._running_mean ) / ( n_a + n_b );
+        _m2 += other._m2 + delta * delta * n_a * n_b / ( n_a + n_b );
+      }
+      base_t::merge( other );
+      sketch->merge( *other.sketch );
+    }
     else
       _data.insert( _data.end(), other._data.begin(), other._data.end() );
   }
@@ -0,0 +1,264 @@
+// ==========================================================================
+// Dedmonwakeen's Raid DPS/TPS Simulator.
+// Send questions to natehieter@gmail.com
+// ==========================================================================
+
+#ifdef UNIT_TEST
+// Code to test the delta timeline against dense per-second collection, and to compare their cost
+
+#include "timeline.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <random>
+
+#include "lib/fmt/format.h"
+#include "util/chrono.hpp"
+
+using test_clock = chrono::cpu_clock;
+
+namespace
+{
+int failures = 0;
+
+void check( bool ok, const std::string& what )
+{
+  if ( !ok )
+  {
+    fmt::print( "FAILED: {}\n", what );
+    ++failures;
+  }
+}
+
+struct interval_t
+{
+  timespan_t start, end;
+  int value;
+};
+
+// The dense per-second collection buff_t used before delta timelines
+void add_dense( sc_timeline_t& timeline, timespan_t last_time, timespan_t current_time, int mul )
+{
+  timespan_t start_time    = timespan_t::from_seconds( last_time.total_millis() / 1000 );
+  timespan_t end_time      = timespan_t::from_seconds( current_time.total_millis() / 1000 );
+  timespan_t begin_partial = 1_s - ( last_time % 1_s );
+  timespan_t end_partial   = ( current_time % 1_s );
+
+  if ( last_time % 1_s == timespan_t::zero() )
+    begin_partial = 1_s;
+
+  if ( start_time == end_time )
+  {
+    timeline.add( start_time, ( current_time.total_seconds() - last_time.total_seconds() ) * mul );
+    return;
+  }
+
+  timeline.add( start_time, begin_partial.total_seconds() * mul );
+
+  for ( timespan_t i = start_time + 1000_ms; i < end_time; i = i + 1000_ms )
+    timeline.add( i, mul );
+
+  timeline.add( end_time, end_partial.total_seconds() * mul );
+}
+
+// Value * milliseconds per bin, computed bin by bin
+std::vector<int64_t> reference( const std::vector<interval_t>& intervals )
+{
+  std::vector<int64_t> bins;
+  for ( const auto& i : intervals )
+  {
+    size_t end_bin = static_cast<size_t>( i.end.total_millis() / 1000 );
+    if ( bins.size() <= end_bin )
+      bins.resize( end_bin + 1 );
+    for ( size_t bin = static_cast<size_t>( i.start.total_millis() / 1000 ); bin <= end_bin; ++bin )
+    {
+      int64_t from = std::max<int64_t>( i.start.total_millis(), bin * 1000 );
+      int64_t to   = std::min<int64_t>( i.end.total_millis(), ( bin + 1 ) * 1000 );
+      bins[ bin ] += std::max<int64_t>( 0, to - from ) * i.value;
+    }
+  }
+  return bins;
+}
+
+// Buff-like intervals: gaps and durations from instant to minutes, many on whole seconds
+std::vector<interval_t> random_intervals( std::mt19937_64& rng, size_t n )
+{
+  std::vector<interval_t> intervals;
+  int64_t now = 0;
+  for ( size_t i = 0; i < n; ++i )
+  {
+    auto random_ms = [ &rng ]( int64_t max ) {
+      int64_t ms = static_cast<int64_t>( rng() % static_cast<uint64_t>( max ) );
+      return rng() % 4 == 0 ? ms - ms % 1000 : ms;
+    };
+    now += random_ms( 20000 );
+    int64_t length = rng() % 8 == 0 ? random_ms( 200000 ) : random_ms( 12000 );
+    intervals.push_back( { timespan_t::from_millis( now ), timespan_t::from_millis( now + length ),
+                           1 + static_cast<int>( rng() % 5 ) } );
+    // Overlapping runs, like several stack changes of one buff
+    if ( rng() % 2 )
+      now += length;
+  }
+  return intervals;
+}
+
+void compare( const delta_timeline_t& deltas, const std::vector<int64_t>& expected, const std::string& name )
+{
+  sc_timeline_t dense;
+  deltas.materialize( dense );
+
+  check( dense.data().size() == expected.size(),
+         fmt::format( "{}: {} bins, expected {}", name, dense.data().size(), expected.size() ) );
+  for ( size_t bin = 0; bin < std::min( dense.data().size(), expected.size() ); ++bin )
+  {
+    if ( dense.data()[ bin ] != expected[ bin ] / 1000.0 )
+    {
+      check( false, fmt::format( "{}: bin {} is {}, expected exactly {}", name, bin, dense.data()[ bin ],
+                                 expected[ bin ] / 1000.0 ) );
+      return;
+    }
+  }
+}
+
+void test_exact( uint64_t seed, size_t n )
+{
+  std::mt19937_64 rng( seed );
+  auto intervals = random_intervals( rng, n );
+  auto expected  = reference( intervals );
+
+  delta_timeline_t deltas;
+  sc_timeline_t dense;
+  for ( const auto& i : intervals )
+  {
+    deltas.add( i.start, i.end, i.value );
+    add_dense( dense, i.start, i.end, i.value );
+  }
+
+  auto name = fmt::format( "seed={} n={}", seed, n );
+  compare( deltas, expected, name );
+
+  // The dense collection rounds each second through floating point, so only matches up to rounding
+  double worst = 0;
+  for ( size_t bin = 0; bin < std::min( dense.data().size(), expected.size() ); ++bin )
+    worst = std::max( worst, std::fabs( dense.data()[ bin ] - expected[ bin ] / 1000.0 ) );
+  check( worst < 1e-9, fmt::format( "{}: dense collection differs by {}", name, worst ) );
+}
+
+// Per thread timelines merged in different orders must equal the whole timeline
+void test_merge( uint64_t seed, size_t parts, size_t n_per_part )
+{
+  std::mt19937_64 rng( seed );
+  std::vector<interval_t> all;
+  std::vector<delta_timeline_t> part( parts );
+  for ( size_t p = 0; p < parts; ++p )
+  {
+    for ( const auto& i : random_intervals( rng, n_per_part * ( p + 1 ) ) )
+    {
+      all.push_back( i );
+      part[ p ].add( i.start, i.end, i.value );
+    }
+  }
+  auto expected = reference( all );
+
+  delta_timeline_t forward;
+  for ( const auto& p : part )
+    forward.merge( p );
+  compare( forward, expected, fmt::format( "seed={} forward merge", seed ) );
+
+  auto tree = part;
+  for ( size_t stride = 1; stride < parts; stride *= 2 )
+  {
+    for ( size_t p = 0; p + stride < parts; p += 2 * stride )
+      tree[ p ].merge( tree[ p + stride ] );
+  }
+  compare( tree[ 0 ], expected, fmt::format( "seed={} tree merge", seed ) );
+}
+
+struct pattern_t
+{
+  const char* name;
+  int64_t duration_ms, period_ms;
+};
+
+// Collect 'iterations' fights per thread the way buff_t does, merge the threads and build the
+// reported timeline. Returns cpu seconds.
+template <typename Collect, typename Finish>
+double run( const pattern_t& pattern, unsigned threads, unsigned iterations, Collect collect, Finish finish )
+{
+  const int64_t fight_ms = 300000;
+  auto start_time        = test_clock::now();
+
+  for ( unsigned t = 0; t < threads; ++t )
+  {
+    for ( unsigned i = 0; i < iterations; ++i )
+    {
+      // Shift every fight a little, so the same run boundaries do not repeat
+      for ( int64_t start = ( i * 37 ) % pattern.period_ms; start < fight_ms; start += pattern.period_ms )
+        collect( t, timespan_t::from_millis( start ),
+                 timespan_t::from_millis( std::min( fight_ms, start + pattern.duration_ms ) ) );
+    }
+  }
+  finish();
+
+  return chrono::elapsed_fp_seconds( start_time );
+}
+
+void benchmark( const pattern_t& pattern, unsigned threads, unsigned iterations )
+{
+  std::vector<sc_timeline_t> dense( threads );
+  double dense_seconds = run( pattern, threads, iterations,
+    [ & ]( unsigned t, timespan_t start, timespan_t end ) { add_dense( dense[ t ], start, end, 1 ); },
+    [ & ] {
+      for ( unsigned t = 1; t < threads; ++t )
+        dense[ 0 ].merge( dense[ t ] );
+    } );
+
+  std::vector<delta_timeline_t> deltas( threads );
+  sc_timeline_t materialized;
+  double delta_seconds = run( pattern, threads, iterations,
+    [ & ]( unsigned t, timespan_t start, timespan_t end ) { deltas[ t ].add( start, end, 1 ); },
+    [ & ] {
+      for ( unsigned t = 1; t < threads; ++t )
+        deltas[ 0 ].merge( deltas[ t ] );
+      deltas[ 0 ].materialize( materialized );
+    } );
+
+  bool same = materialized.data().size() == dense[ 0 ].data().size();
+  for ( size_t bin = 0; same && bin < materialized.data().size(); ++bin )
+    same = std::fabs( materialized.data()[ bin ] - dense[ 0 ].data()[ bin ] ) < 1e-6;
+  check( same, fmt::format( "benchmark {}: timelines differ", pattern.name ) );
+
+  fmt::print( "{:>12} {:>12.3f} {:>12.3f}\n", pattern.name, dense_seconds * 1000, delta_seconds * 1000 );
+}
+}  // namespace
+
+int main( int argc, char** argv )
+{
+  uint64_t seed = argc > 1 ? std::strtoull( argv[ 1 ], nullptr, 10 ) : 12345;
+  fmt::print( "Seed: {}\n\n", seed );
+
+  for ( uint64_t i = 0; i < 20; ++i )
+    test_exact( seed + i, 1 + static_cast<size_t>( i * i * 10 ) );
+  for ( uint64_t i = 0; i < 5; ++i )
+    test_merge( seed + i, 8, 200 );
+
+  fmt::print( "Delta timeline tests: {}\n\n", failures ? "FAILED" : "passed" );
+
+  const unsigned threads = 8, iterations = 1250;
+  const pattern_t patterns[] = {
+    { "always up", 300000, 300000 },
+    { "long buff", 20000, 60000 },
+    { "proc", 6000, 15000 },
+    { "short proc", 1500, 4000 },
+  };
+
+  fmt::print( "{} threads x {} iterations of a 300s fight, cpu ms for collect, merge and materialize:\n",
+              threads, iterations );
+  fmt::print( "{:>12} {:>12} {:>12}\n", "pattern", "dense", "deltas" );
+  for ( const auto& pattern : patterns )
+    benchmark( pattern, threads, iterations );
+
+  return failures ? 1 : 0;
+}
+
+#endif  // UNIT_TEST
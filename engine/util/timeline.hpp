@@ -8,8 +8,10 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <cstring>
 #include <numeric>
+#include <utility>
 #include <vector>
 
 #include "util/generic.hpp"
@@ -239,11 +241,11 @@ public:
    */
   void create_histogram( const extended_sample_data_t& sd, size_t num_buckets, double min, double max )
   {
-    if ( sd.simple || sd.data().empty() )
+    if ( sd.simple || sd.count() == 0 )
       return;
     clear();
     _min = min; _max = max;
-    _data = statistics::create_histogram( sd.data(), num_buckets, _min, _max );
+    _data = sd.histogram( num_buckets, _min, _max );
     calculate_num_entries();
   }
 
@@ -251,8 +253,14 @@ public:
    */
   void create_histogram( const extended_sample_data_t& sd, size_t num_buckets )
   {
-    if ( sd.simple || sd.data().empty() )
+    if ( sd.simple || sd.count() == 0 )
       return;
+    // Sketched data tracks exact min/max while adding
+    if ( sd.sketched() )
+    {
+      create_histogram( sd, num_buckets, sd.min(), sd.max() );
+      return;
+    }
     double min = *std::min_element( sd.data().begin(), sd.data().end() );
     double max = *std::max_element( sd.data().begin(), sd.data().end() );
     create_histogram( sd, num_buckets, min, max );
@@ -408,4 +416,80 @@ private:
   double bin_size_mul_; // optimization: premultipled bin_size_
 };
 
+/* Per-second timeline of integer values held over time intervals (e.g. buff stacks):
+ * - A run adds value * ( overlap in seconds ) to each bin it overlaps
+ * - Runs are stored as bin deltas of the timeline (a difference array), so adding a run costs the
+ *   same regardless of its length
+ * - Deltas are kept in value * milliseconds, so accumulation and merging are exact
+ * - materialize() builds the equivalent dense timeline
+ */
+class delta_timeline_t
+{
+  // Deltas per bin, one past the last bin of the dense timeline
+  std::vector<int64_t> _deltas;
+
+  void add_delta( size_t bin, int64_t value )
+  {
+    if ( bin >= _deltas.size() )
+      _deltas.resize( bin + 1 );
+    _deltas[ bin ] += value;
+  }
+
+public:
+  bool empty() const
+  { return _deltas.empty(); }
+
+  // Add 'value' over the time interval [ start, end )
+  void add( timespan_t start, timespan_t end, int64_t value )
+  {
+    const int64_t start_ms = start.total_millis();
+    const int64_t end_ms   = end.total_millis();
+    const size_t start_bin = static_cast<size_t>( start_ms / 1000 );
+    const size_t end_bin   = static_cast<size_t>( end_ms / 1000 );
+
+    // The last delta goes one past the end bin, which also sizes the timeline
+    add_delta( end_bin + 1, -( end_ms % 1000 ) * value );
+
+    if ( start_bin == end_bin )
+    {
+      _deltas[ start_bin ] += ( end_ms - start_ms ) * value;
+      _deltas[ end_bin + 1 ] -= ( end_ms - start_ms - end_ms % 1000 ) * value;
+      return;
+    }
+
+    // Partial first second, whole seconds in between, partial last second
+    const int64_t begin_partial = 1000 - start_ms % 1000;
+    _deltas[ start_bin ] += begin_partial * value;
+    _deltas[ start_bin + 1 ] += ( 1000 - begin_partial ) * value;
+    _deltas[ end_bin ] += ( end_ms % 1000 - 1000 ) * value;
+  }
+
+  void merge( const delta_timeline_t& other )
+  {
+    if ( other._deltas.size() > _deltas.size() )
+      _deltas.resize( other._deltas.size() );
+    for ( size_t bin = 0; bin < other._deltas.size(); ++bin )
+      _deltas[ bin ] += other._deltas[ bin ];
+  }
+
+  // Build the dense timeline, in value * seconds per bin
+  void materialize( timeline_t& out ) const
+  {
+    const size_t length = _deltas.empty() ? 0 : _deltas.size() - 1;
+    out.init( length );
+
+    int64_t value = 0;
+    for ( size_t bin = 0; bin < length; ++bin )
+    {
+      value += _deltas[ bin ];
+      assert( value >= 0 && "Negative value held over an interval" );
+      if ( value != 0 )
+        out.add( bin, value / 1000.0 );
+    }
+  }
+
+  void clear()
+  { _deltas.clear(); }
+};
+
 #endif // TIMELINE_HPP
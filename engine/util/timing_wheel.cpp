@@ -0,0 +1,291 @@
+// ==========================================================================
+// Dedmonwakeen's Raid DPS/TPS Simulator.
+// Send questions to natehieter@gmail.com
+// ==========================================================================
+
+#ifdef UNIT_TEST
+// Code to test functionality and performance of the event timing wheel
+
+#include "timing_wheel.hpp"
+
+#include <cstdlib>
+#include <queue>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "lib/fmt/format.h"
+#include "util/chrono.hpp"
+
+using test_clock = chrono::cpu_clock;
+
+namespace
+{
+struct node_t
+{
+  node_t*  next;
+  uint64_t time;
+  uint64_t seq;
+};
+
+struct node_time_t
+{
+  static uint64_t get( const node_t* n )
+  { return n->time; }
+};
+
+using wheel_t = timing_wheel_t<node_t, node_time_t>;
+
+/* The single level event queue the simulator used before the hierarchical wheel: a wheel of
+ * 2^15 slices of 32 ms, each holding a list sorted by time. Delays beyond the wheel span have to
+ * be parked and rescheduled by the caller; the benchmark only uses delays within the span.
+ */
+struct sorted_wheel_t
+{
+  static constexpr unsigned SHIFT = 5;
+  static constexpr uint64_t MASK  = ( uint64_t( 1 ) << 15 ) - 1;
+
+  std::vector<node_t*> slices;
+  uint64_t slice;
+
+  sorted_wheel_t() : slices( MASK + 1 ), slice( 0 )
+  { }
+
+  void insert( node_t* n )
+  {
+    node_t** prev = &slices[ ( n->time >> SHIFT ) & MASK ];
+    while ( *prev && ( *prev )->time <= n->time )
+      prev = &( *prev )->next;
+    n->next = *prev;
+    *prev   = n;
+  }
+
+  // Caller must know the queue is not empty
+  node_t* pop()
+  {
+    while ( true )
+    {
+      node_t*& list = slices[ slice ];
+      if ( list )
+      {
+        node_t* n = list;
+        list      = n->next;
+        return n;
+      }
+      slice = ( slice + 1 ) & MASK;
+    }
+  }
+};
+
+struct reference_order_t
+{
+  bool operator()( const node_t* l, const node_t* r ) const
+  { return std::tie( l->time, l->seq ) > std::tie( r->time, r->seq ); }
+};
+
+int failures = 0;
+
+void check( bool ok, const std::string& what )
+{
+  if ( !ok )
+  {
+    fmt::print( "FAILED: {}\n", what );
+    ++failures;
+  }
+}
+
+// Delay distribution touching every wheel level, with a lot of ties
+uint64_t random_delay( std::mt19937_64& rng )
+{
+  switch ( rng() % 8 )
+  {
+    case 0:
+      return 0;
+    case 1:
+      return rng() % 64;
+    case 2:
+      return rng() % 4096;
+    case 3:
+      return 1000 * ( rng() % 8 );
+    case 4:
+      return rng() % 300000;
+    case 5:
+      return rng() % ( uint64_t( 1 ) << 30 );
+    case 6:
+      return rng() % ( uint64_t( 1 ) << 50 );
+    default:
+      return uint64_t( 1 ) << ( rng() % 60 );
+  }
+}
+
+// Pop everything from the wheel and the reference queue, checking that both agree
+void drain_and_compare( wheel_t& wheel, std::priority_queue<node_t*, std::vector<node_t*>, reference_order_t>& ref,
+                        const std::string& name )
+{
+  while ( !ref.empty() )
+  {
+    node_t* expected = ref.top();
+    ref.pop();
+    node_t* n = wheel.pop();
+    if ( n != expected )
+    {
+      check( false, fmt::format( "{}: popped time={} seq={}, expected time={} seq={}", name, n ? n->time : 0,
+                                 n ? n->seq : 0, expected->time, expected->seq ) );
+      return;
+    }
+  }
+  check( wheel.pop() == nullptr, name + ": wheel not empty after draining" );
+}
+
+// Insert nodes at and around the level boundaries, relative to a cursor that is not aligned
+void test_level_boundaries()
+{
+  wheel_t wheel;
+  std::priority_queue<node_t*, std::vector<node_t*>, reference_order_t> ref;
+  std::vector<node_t> nodes;
+  nodes.reserve( 1024 );
+  uint64_t seq = 0;
+
+  // Move the cursor off zero first
+  nodes.push_back( { nullptr, 12345, seq++ } );
+  wheel.insert( &nodes.back() );
+  check( wheel.pop() == &nodes.back(), "boundaries: initial pop" );
+
+  for ( unsigned level = 0; level < wheel_t::LEVELS; ++level )
+  {
+    uint64_t boundary = uint64_t( 1 ) << std::min( 63U, level * wheel_t::LEVEL_BITS );
+    for ( uint64_t t : { boundary - 1, boundary, boundary + 1, boundary + 12345 } )
+    {
+      if ( t < 12345 )
+        continue;
+      for ( int dup = 0; dup < 2; ++dup )
+      {
+        nodes.push_back( { nullptr, t, seq++ } );
+        wheel.insert( &nodes.back() );
+        ref.push( &nodes.back() );
+      }
+    }
+  }
+
+  drain_and_compare( wheel, ref, "boundaries" );
+}
+
+// Hold model: pop the earliest node, and insert new ones relative to its time
+void test_random_order( uint64_t seed, unsigned pending, unsigned operations )
+{
+  std::mt19937_64 rng( seed );
+  wheel_t wheel;
+  std::priority_queue<node_t*, std::vector<node_t*>, reference_order_t> ref;
+  std::vector<node_t> nodes( pending + operations );
+  uint64_t seq = 0, now = 0;
+
+  auto add = [ & ]( uint64_t time ) {
+    node_t* n = &nodes[ seq ];
+    n->time   = time;
+    n->seq    = seq++;
+    wheel.insert( n );
+    ref.push( n );
+  };
+
+  for ( unsigned i = 0; i < pending; ++i )
+    add( random_delay( rng ) );
+
+  for ( unsigned i = 0; i < operations && !ref.empty(); ++i )
+  {
+    node_t* expected = ref.top();
+    ref.pop();
+    node_t* n = wheel.pop();
+    if ( n != expected )
+    {
+      check( false, fmt::format( "random seed={}: pop {} returned time={}, expected time={} seq={}", seed, i,
+                                 n ? n->time : 0, expected->time, expected->seq ) );
+      return;
+    }
+    now = n->time;
+
+    // Keep the queue size roughly constant, occasionally growing or shrinking it
+    unsigned inserts = rng() % 4 == 0 ? static_cast<unsigned>( rng() % 3 ) : 1;
+    for ( unsigned j = 0; j < inserts && seq < nodes.size(); ++j )
+    {
+      uint64_t delay = random_delay( rng );
+      add( now + std::min( delay, ~uint64_t( 0 ) - now ) );
+    }
+  }
+
+  drain_and_compare( wheel, ref, fmt::format( "random seed={}", seed ) );
+}
+
+// Typical simulation delays: mostly short, some gcd/cooldown length, few long timers
+uint64_t sim_delay( std::mt19937_64& rng )
+{
+  switch ( rng() % 16 )
+  {
+    case 0:
+      return 0;
+    case 1:
+      return 60000 + rng() % 120000;
+    case 2:
+    case 3:
+    case 4:
+      return 1000 + rng() % 500;
+    default:
+      return rng() % 3000;
+  }
+}
+
+template <typename Queue>
+double benchmark( unsigned pending, uint64_t operations, uint64_t seed )
+{
+  std::mt19937_64 rng( seed );
+  Queue queue;
+  std::vector<node_t> nodes( pending );
+
+  for ( auto& n : nodes )
+  {
+    n.time = sim_delay( rng );
+    queue.insert( &n );
+  }
+
+  auto start_time = test_clock::now();
+
+  uint64_t checksum = 0;
+  for ( uint64_t i = 0; i < operations; ++i )
+  {
+    node_t* n = queue.pop();
+    checksum += n->time;
+    n->time += sim_delay( rng );
+    queue.insert( n );
+  }
+
+  double elapsed = chrono::elapsed_fp_seconds( start_time );
+  check( checksum != 0, "benchmark checksum" );
+
+  return elapsed * 1e9 / operations;
+}
+}  // namespace
+
+int main( int argc, char** argv )
+{
+  uint64_t seed = argc > 1 ? std::strtoull( argv[ 1 ], nullptr, 10 ) : 12345;
+  fmt::print( "Seed: {}\n\n", seed );
+
+  test_level_boundaries();
+  for ( uint64_t i = 0; i < 20; ++i )
+    test_random_order( seed + i, 1 + static_cast<unsigned>( i * i * 50 ), 200000 );
+
+  fmt::print( "Ordering tests: {}\n\n", failures ? "FAILED" : "passed" );
+
+  const uint64_t operations = 20'000'000;
+  fmt::print( "Hold model, {} pop+insert operations, ns per operation:\n", operations );
+  fmt::print( "{:>10} {:>16} {:>16}\n", "pending", "sorted wheel", "timing wheel" );
+  for ( unsigned pending : { 16U, 128U, 1024U, 8192U, 65536U } )
+  {
+    double sorted = benchmark<sorted_wheel_t>( pending, operations, seed );
+    double wheel  = benchmark<wheel_t>( pending, operations, seed );
+    fmt::print( "{:>10} {:>16.1f} {:>16.1f}\n", pending, sorted, wheel );
+  }
+
+  return failures ? 1 : 0;
+}
+
+#endif  // UNIT_TEST
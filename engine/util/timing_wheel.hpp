@@ -0,0 +1,190 @@
+// ==========================================================================
+// Dedmonwakeen's Raid DPS/TPS Simulator.
+// Send questions to natehieter@gmail.com
+// ==========================================================================
+
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+
+#if defined( _MSC_VER )
+#include <intrin.h>
+#endif
+
+/* Hierarchical timing wheel of intrusive, singly linked nodes
+ *
+ * Level 0 has a slot per tick, each higher level covers WHEEL_SLOTS slots of the level below it. A
+ * node is stored on the highest level where its time differs from the wheel cursor, and is
+ * cascaded down when the cursor reaches its slot. Slots are FIFO lists, so nodes with the same time
+ * are popped in insertion order. Per-level occupancy bitmasks find the next slot with bit scans.
+ *
+ * T needs a "T* next" member, and Time a static "uint64_t get( const T* )" returning the time of a
+ * node in ticks. Nodes may not be inserted before the time of the last popped node.
+ */
+template <typename T, typename Time>
+class timing_wheel_t
+{
+public:
+  static constexpr unsigned LEVEL_BITS = 6;
+  static constexpr unsigned SLOTS      = 1U << LEVEL_BITS;
+  static constexpr unsigned LEVELS     = ( 64 + LEVEL_BITS - 1 ) / LEVEL_BITS;
+
+  timing_wheel_t() : wheel(), occupancy(), cursor( 0 ), n_cascaded( 0 )
+  { }
+
+  // Insert a node, returns the level it was stored on
+  unsigned insert( T* node )
+  {
+    const uint64_t t = Time::get( node );
+    assert( t >= cursor && "Node inserted before the timing wheel cursor" );
+
+    // The level is the most significant slot index in which the node time differs from the cursor
+    const uint64_t diff  = t ^ cursor;
+    const unsigned level = diff < SLOTS ? 0 : highest_bit( diff ) / LEVEL_BITS;
+    const unsigned slot  = static_cast<unsigned>( t >> ( level * LEVEL_BITS ) ) & ( SLOTS - 1 );
+
+    auto& s    = wheel[ level ][ slot ];
+    node->next = nullptr;
+    if ( s.tail )
+    {
+      s.tail->next = node;
+    }
+    else
+    {
+      s.head = node;
+      occupancy[ level ] |= uint64_t( 1 ) << slot;
+    }
+    s.tail = node;
+
+    return level;
+  }
+
+  // Remove and return the earliest node, nullptr if the wheel is empty
+  T* pop()
+  {
+    while ( true )
+    {
+      // Earliest occupied level 0 slot at or after the cursor
+      const unsigned cursor_slot = static_cast<unsigned>( cursor ) & ( SLOTS - 1 );
+      const uint64_t pending     = occupancy[ 0 ] & ( ~uint64_t( 0 ) << cursor_slot );
+      if ( pending )
+      {
+        const unsigned slot = lowest_bit( pending );
+        cursor              = ( cursor & ~uint64_t( SLOTS - 1 ) ) | slot;
+
+        auto& s = wheel[ 0 ][ slot ];
+        T* node = s.head;
+        s.head  = node->next;
+        if ( !s.head )
+        {
+          s.tail = nullptr;
+          occupancy[ 0 ] &= ~( uint64_t( 1 ) << slot );
+        }
+        node->next = nullptr;
+
+        return node;
+      }
+
+      // Level 0 is exhausted. Advance the cursor to the start of the next occupied slot on the
+      // lowest possible higher level, and cascade that slot's nodes down. Slots at or before the
+      // cursor on higher levels are always empty, as their nodes have already been cascaded.
+      if ( !cascade() )
+        return nullptr;
+    }
+  }
+
+  void clear()
+  {
+    for ( unsigned level = 0; level < LEVELS; ++level )
+    {
+      while ( occupancy[ level ] )
+      {
+        unsigned slot = lowest_bit( occupancy[ level ] );
+        wheel[ level ][ slot ] = slot_t();
+        occupancy[ level ] &= occupancy[ level ] - 1;
+      }
+    }
+    cursor = 0;
+  }
+
+  // Number of nodes moved down a level since construction
+  uint64_t cascaded() const
+  { return n_cascaded; }
+
+  // Index of the lowest set bit, v must be non-zero
+  static unsigned lowest_bit( uint64_t v )
+  {
+    assert( v != 0 );
+#if defined( _MSC_VER )
+    unsigned long idx;
+    _BitScanForward64( &idx, v );
+    return static_cast<unsigned>( idx );
+#else
+    return static_cast<unsigned>( __builtin_ctzll( v ) );
+#endif
+  }
+
+  // Index of the highest set bit, v must be non-zero
+  static unsigned highest_bit( uint64_t v )
+  {
+    assert( v != 0 );
+#if defined( _MSC_VER )
+    unsigned long idx;
+    _BitScanReverse64( &idx, v );
+    return static_cast<unsigned>( idx );
+#else
+    return 63U - static_cast<unsigned>( __builtin_clzll( v ) );
+#endif
+  }
+
+private:
+  struct slot_t
+  {
+    T* head;
+    T* tail;
+  };
+
+  std::array<std::array<slot_t, SLOTS>, LEVELS> wheel;
+  std::array<uint64_t, LEVELS> occupancy;
+  uint64_t cursor;
+  uint64_t n_cascaded;
+
+  // Cascade the next occupied higher level slot down, returns false if the wheel is empty
+  bool cascade()
+  {
+    for ( unsigned level = 1; level < LEVELS; ++level )
+    {
+      const unsigned shift      = level * LEVEL_BITS;
+      const unsigned level_slot = static_cast<unsigned>( cursor >> shift ) & ( SLOTS - 1 );
+      if ( level_slot + 1 == SLOTS )
+        continue;
+
+      const uint64_t level_pending = occupancy[ level ] & ( ~uint64_t( 0 ) << ( level_slot + 1 ) );
+      if ( !level_pending )
+        continue;
+
+      const unsigned slot     = lowest_bit( level_pending );
+      const unsigned shift_up = shift + LEVEL_BITS;
+      const uint64_t upper    = shift_up >= 64 ? 0 : cursor & ( ~uint64_t( 0 ) << shift_up );
+      cursor                  = upper | ( uint64_t( slot ) << shift );
+
+      T* node = wheel[ level ][ slot ].head;
+      wheel[ level ][ slot ] = slot_t();
+      occupancy[ level ] &= ~( uint64_t( 1 ) << slot );
+
+      // Re-inserting in list order keeps nodes with identical times in insertion order
+      while ( node )
+      {
+        T* next = node->next;
+        insert( node );
+        ++n_cascaded;
+        node = next;
+      }
+      return true;
+    }
+
+    return false;
+  }
+};
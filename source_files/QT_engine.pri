@@ -142,6 +142,7 @@ HEADERS += engine/report/color.hpp
 HEADERS += engine/report/decorators.hpp
 HEADERS += engine/report/gear_weights.hpp
 HEADERS += engine/report/highchart.hpp
+HEADERS += engine/report/json/json_stream.hpp
 HEADERS += engine/report/json/report_configuration.hpp
 HEADERS += engine/report/report_helper.hpp
 HEADERS += engine/report/report_timer.hpp
@@ -155,6 +156,7 @@ HEADERS += engine/sim/event_manager.hpp
 HEADERS += engine/sim/expressions.hpp
 HEADERS += engine/sim/gain.hpp
 HEADERS += engine/sim/iteration_data_entry.hpp
+HEADERS += engine/sim/iteration_data_file.hpp
 HEADERS += engine/sim/option.hpp
 HEADERS += engine/sim/plot.hpp
 HEADERS += engine/sim/proc.hpp
@@ -179,6 +181,7 @@ HEADERS += engine/util/format.hpp
 HEADERS += engine/util/generic.hpp
 HEADERS += engine/util/git_info.hpp
 HEADERS += engine/util/io.hpp
+HEADERS += engine/util/name_index.hpp
 HEADERS += engine/util/plot_data.hpp
 HEADERS += engine/util/resourcepaths.hpp
 HEADERS += engine/util/rng.hpp
@@ -191,6 +194,7 @@ HEADERS += engine/util/stopwatch.hpp
 HEADERS += engine/util/string_view.hpp
 HEADERS += engine/util/timeline.hpp
 HEADERS += engine/util/timespan.hpp
+HEADERS += engine/util/timing_wheel.hpp
 HEADERS += engine/util/util.hpp
 HEADERS += engine/util/vector_with_callback.hpp
 HEADERS += engine/util/xml.hpp
@@ -331,6 +335,7 @@ SOURCES += engine/report/color.cpp
 SOURCES += engine/report/decorators.cpp
 SOURCES += engine/report/gear_weights.cpp
 SOURCES += engine/report/highchart.cpp
+SOURCES += engine/report/json/json_stream.cpp
 SOURCES += engine/report/json/report_configuration.cpp
 SOURCES += engine/report/json/report_json.cpp
 SOURCES += engine/report/report_helper.cpp
@@ -344,6 +349,7 @@ SOURCES += engine/sim/event.cpp
 SOURCES += engine/sim/event_manager.cpp
 SOURCES += engine/sim/expressions.cpp
 SOURCES += engine/sim/gear_stats.cpp
+SOURCES += engine/sim/iteration_data_file.cpp
 SOURCES += engine/sim/option.cpp
 SOURCES += engine/sim/plot.cpp
 SOURCES += engine/sim/proc.cpp
@@ -357,13 +363,17 @@ SOURCES += engine/sim/shuffled_rng.cpp
 SOURCES += engine/sim/sim.cpp
 SOURCES += engine/sim/sim_ostream.cpp
 SOURCES += engine/sim/uptime_benefit.cpp
+SOURCES += engine/sim/work_queue.cpp
 SOURCES += engine/util/cache.cpp
 SOURCES += engine/util/chrono.cpp
 SOURCES += engine/util/concurrency.cpp
 SOURCES += engine/util/git_info.cpp
 SOURCES += engine/util/io.cpp
 SOURCES += engine/util/rng.cpp
+SOURCES += engine/util/sample_data.cpp
+SOURCES += engine/util/timeline.cpp
 SOURCES += engine/util/timespan.cpp
+SOURCES += engine/util/timing_wheel.cpp
 SOURCES += engine/util/util.cpp
 SOURCES += engine/util/xml.cpp
 
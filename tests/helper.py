@@ -2,6 +2,8 @@ import sys, os, shutil, subprocess, re, signal
 from pathlib import Path
 
 def __error_status(code):
+    if code == 0:
+        return 'Process succeeded, expected an error'
     if code and code < 0:
         try:
             return 'Process died with %r' % signal.Signals(-code)
@@ -57,6 +59,8 @@ class Test(object):
         self._all_talents = kwargs.get('all_talents', False)
         self._all_sets = kwargs.get('all_sets', False)
         self._args = kwargs.get('args', [])
+        # Text of the error simc is expected to exit with, for invalid setups
+        self.expect_error = kwargs.get('expect_error')
 
     def args(self):
         args = [
@@ -86,6 +90,12 @@ def run_test(test):
     args = [ SIMC_CLI_PATH ]
     args.extend(test.args())
 
+    if test.expect_error:
+        res = subprocess.run(args, stdout=subprocess.PIPE, stderr=subprocess.PIPE, encoding='UTF-8', timeout=30)
+        if res.returncode > 0 and test.expect_error in res.stderr:
+            return ( True, 0, None, None )
+        return ( False, 0, subprocess.CalledProcessError(res.returncode, args, res.stdout, res.stderr), res.stderr )
+
     try:
         res = subprocess.run(args, check=True, stdout=subprocess.PIPE, stderr=subprocess.PIPE, encoding='UTF-8', timeout=30)
         wall_time = SIMC_WALL_SECONDS_RE.search(res.stdout)
@@ -72,9 +72,27 @@ def test_baseline(klass: str, path: str, enable: dict):
         ],
     )
 
+# Test that invalid option combinations are rejected
+def test_options(klass: str, path: str, enable: dict):
+    grp = TestGroup(
+        "{}/options".format(profile),
+        profile=path,
+    )
+    tests.append(grp)
+    Test(
+        "common random numbers with sketched statistics",
+        group=grp,
+        expect_error="common_random_numbers=1 cannot be used with non-zero statistics_sketch_accuracy",
+        args=[
+            ( "common_random_numbers", "1" ),
+            ( "statistics_sketch_accuracy", "0.01" )
+        ]
+    )
+
 available_tests = {
     "trinket": test_trinkets,
     "baseline": test_baseline,
+    "options": test_options,
 }
 
 parser = argparse.ArgumentParser(description="Run simc tests.")
@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+
+# Reader for the binary per-iteration output of the simulator (iteration_data_file=<file>). Prints
+# the rows as CSV, or a per-column summary with --summary. See engine/sim/iteration_data_file.hpp
+# for the file format.
+
+import argparse, array, csv, math, struct, sys
+
+MAGIC = b'SCITDATA'
+TYPECODES = { 0: 'Q', 1: 'd' }
+
+def read_exact(f, size):
+    data = f.read(size)
+    if len(data) != size:
+        raise EOFError()
+    return data
+
+def read_header(f):
+    if f.read(len(MAGIC)) != MAGIC:
+        raise ValueError('Not an iteration data file')
+
+    version, n_columns = struct.unpack('<II', read_exact(f, 8))
+    if version != 1:
+        raise ValueError('Unsupported iteration data version %d' % version)
+
+    columns = []
+    for _ in range(n_columns):
+        column_type, name_length = struct.unpack('<BH', read_exact(f, 3))
+        columns.append((read_exact(f, name_length).decode('utf-8'), TYPECODES[column_type]))
+    return columns
+
+# Yield blocks as lists of column value arrays, in header order
+def read_blocks(f, columns):
+    while True:
+        data = f.read(4)
+        if not data:
+            return
+
+        try:
+            n_rows, = struct.unpack('<I', data)
+            block = []
+            for _, typecode in columns:
+                values = array.array(typecode)
+                values.frombytes(read_exact(f, n_rows * values.itemsize))
+                if sys.byteorder != 'little':
+                    values.byteswap()
+                block.append(values)
+        except EOFError:
+            # Truncated last block (e.g. an interrupted sim)
+            return
+
+        yield block
+
+def print_csv(f, columns, selected):
+    writer = csv.writer(sys.stdout)
+    writer.writerow([ columns[i][0] for i in selected ])
+    for block in read_blocks(f, columns):
+        for row in zip(*(block[i] for i in selected)):
+            writer.writerow(row)
+
+def print_summary(f, columns, selected):
+    n = [ 0 ] * len(columns)
+    total = [ 0.0 ] * len(columns)
+    minimum = [ math.inf ] * len(columns)
+    maximum = [ -math.inf ] * len(columns)
+    for block in read_blocks(f, columns):
+        for i in selected:
+            values = [ v for v in block[i] if not math.isnan(v) ]
+            if values:
+                n[i] += len(values)
+                total[i] += math.fsum(values)
+                minimum[i] = min(minimum[i], min(values))
+                maximum[i] = max(maximum[i], max(values))
+
+    print('%-40s %10s %16s %16s %16s' % ('column', 'rows', 'mean', 'min', 'max'))
+    for i in selected:
+        if n[i]:
+            print('%-40s %10d %16.4f %16.4f %16.4f' % (columns[i][0], n[i], total[i] / n[i], minimum[i], maximum[i]))
+
+def main():
+    parser = argparse.ArgumentParser(description='Read a binary iteration data file')
+    parser.add_argument('file', help='iteration data file')
+    parser.add_argument('-c', '--columns', help='comma separated list of columns to output (default: all)')
+    parser.add_argument('-s', '--summary', action='store_true', help='print count, mean, min and max per column')
+    args = parser.parse_args()
+
+    with open(args.file, 'rb') as f:
+        columns = read_header(f)
+        names = [ name for name, _ in columns ]
+
+        if args.columns:
+            try:
+                selected = [ names.index(name) for name in args.columns.split(',') ]
+            except ValueError as e:
+                parser.error('Unknown column: %s' % e)
+        else:
+            selected = list(range(len(columns)))
+
+        if args.summary:
+            print_summary(f, columns, selected)
+        else:
+            print_csv(f, columns, selected)
+
+if __name__ == '__main__':
+    main()